@@ -0,0 +1,254 @@
+/*
+ * Tatoosh - Completion Index Implementation
+ */
+
+#include "completion_index.h"
+#include <algorithm>
+#include <cctype>
+
+namespace Tatoosh {
+
+CompletionIndex g_completion_index;
+
+namespace {
+
+uint8_t KeyOf(char c)
+{
+    return static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+} // namespace
+
+CompletionIndex::CompletionIndex()
+    : m_count(0)
+{
+    m_nodes.emplace_back();
+}
+
+void CompletionIndex::Insert(const char* name, ui_completion_kind_t kind)
+{
+    if (!name || !name[0]) return;
+
+    uint32_t node = 0;
+    m_path.clear();
+    m_path.push_back(node);
+    for (const char* c = name; *c; ++c) {
+        uint8_t key = KeyOf(*c);
+        uint32_t child = FindChild(node, key);
+        if (child == NONE) {
+            child = AddChild(node, key);
+        }
+        node = child;
+        m_path.push_back(node);
+    }
+
+    uint32_t id = m_nodes[node].entry;
+    if (id != NONE) {
+        // Re-registered, e.g. an alias redefined
+        Entry& entry = m_entries[id];
+        entry.name = name;
+        if (entry.kind != kind) {
+            entry.kind = kind;
+            entry.cvar = CvarRef();
+            RebuildPath();
+        }
+        return;
+    }
+
+    Entry entry{name, kind, 0, CvarRef()};
+    if (!m_free.empty()) {
+        id = m_free.back();
+        m_free.pop_back();
+        m_entries[id] = std::move(entry);
+    } else {
+        id = static_cast<uint32_t>(m_entries.size());
+        m_entries.push_back(std::move(entry));
+    }
+    m_nodes[node].entry = id;
+    m_count++;
+
+    for (uint32_t index : m_path) {
+        Promote(m_nodes[index], id);
+    }
+}
+
+void CompletionIndex::Remove(const char* name)
+{
+    if (!name) return;
+
+    uint32_t node = WalkPath(name);
+    if (node == NONE || m_nodes[node].entry == NONE) return;
+
+    uint32_t id = m_nodes[node].entry;
+    m_nodes[node].entry = NONE;
+    m_entries[id] = Entry{std::string(), UI_COMPLETION_COMMAND, 0, CvarRef()};
+    m_free.push_back(id);
+    m_count--;
+
+    // The lists along the path may now have room for names ranked below it.
+    // Nodes stay: an empty subtree just has an empty list.
+    RebuildPath();
+}
+
+void CompletionIndex::RecordUse(const char* name)
+{
+    if (!name) return;
+
+    uint32_t node = WalkPath(name);
+    if (node == NONE || m_nodes[node].entry == NONE) return;
+
+    uint32_t id = m_nodes[node].entry;
+    m_entries[id].uses++;
+
+    for (uint32_t index : m_path) {
+        Promote(m_nodes[index], id);
+    }
+}
+
+size_t CompletionIndex::Complete(const char* prefix, const Entry** results, size_t max_results) const
+{
+    if (!prefix || !results) return 0;
+
+    uint32_t node = FindNode(prefix);
+    if (node == NONE) return 0;
+
+    const Node& found = m_nodes[node];
+    size_t count = std::min<size_t>(max_results, found.top_count);
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = &m_entries[found.top[i]];
+    }
+    return count;
+}
+
+const CompletionIndex::Entry* CompletionIndex::Find(const char* name) const
+{
+    if (!name || !name[0]) return nullptr;
+
+    uint32_t node = FindNode(name);
+    if (node == NONE || m_nodes[node].entry == NONE) return nullptr;
+    return &m_entries[m_nodes[node].entry];
+}
+
+void CompletionIndex::Clear()
+{
+    m_nodes.clear();
+    m_nodes.emplace_back();
+    m_entries.clear();
+    m_free.clear();
+    m_count = 0;
+}
+
+uint32_t CompletionIndex::FindChild(uint32_t node, uint8_t key) const
+{
+    for (uint32_t child = m_nodes[node].first_child; child != NONE; child = m_nodes[child].next_sibling) {
+        if (m_nodes[child].key == key) return child;
+        if (m_nodes[child].key > key) break;
+    }
+    return NONE;
+}
+
+uint32_t CompletionIndex::AddChild(uint32_t node, uint8_t key)
+{
+    uint32_t id = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    m_nodes[id].key = key;
+
+    // Taken after emplace_back, which may have moved the nodes
+    uint32_t* link = &m_nodes[node].first_child;
+    while (*link != NONE && m_nodes[*link].key < key) {
+        link = &m_nodes[*link].next_sibling;
+    }
+    m_nodes[id].next_sibling = *link;
+    *link = id;
+    return id;
+}
+
+uint32_t CompletionIndex::WalkPath(const char* name)
+{
+    uint32_t node = 0;
+    m_path.clear();
+    m_path.push_back(node);
+    for (const char* c = name; *c; ++c) {
+        node = FindChild(node, KeyOf(*c));
+        if (node == NONE) return NONE;
+        m_path.push_back(node);
+    }
+    return node;
+}
+
+uint32_t CompletionIndex::FindNode(const char* name) const
+{
+    uint32_t node = 0;
+    for (const char* c = name; *c && node != NONE; ++c) {
+        node = FindChild(node, KeyOf(*c));
+    }
+    return node;
+}
+
+bool CompletionIndex::Better(uint32_t a, uint32_t b) const
+{
+    const Entry& x = m_entries[a];
+    const Entry& y = m_entries[b];
+    if (x.uses != y.uses) return x.uses > y.uses;
+    if (x.name.size() != y.name.size()) return x.name.size() < y.name.size();
+    if (x.kind != y.kind) return x.kind < y.kind;
+    return x.name < y.name;
+}
+
+void CompletionIndex::Promote(Node& node, uint32_t entry)
+{
+    uint32_t* top = node.top.data();
+    size_t count = node.top_count;
+
+    size_t found = std::find(top, top + count, entry) - top;
+    if (found < count) {
+        std::copy(top + found + 1, top + count, top + found);
+        count--;
+    }
+
+    size_t at = 0;
+    while (at < count && !Better(entry, top[at])) {
+        at++;
+    }
+
+    if (at < MAX_RESULTS) {
+        if (count == MAX_RESULTS) {
+            count--;   // The worst drops out
+        }
+        std::copy_backward(top + at, top + count, top + count + 1);
+        top[at] = entry;
+        count++;
+    }
+    node.top_count = static_cast<uint8_t>(count);
+}
+
+void CompletionIndex::Rebuild(uint32_t index)
+{
+    std::vector<uint32_t> candidates;
+    const Node& node = m_nodes[index];
+    if (node.entry != NONE) {
+        candidates.push_back(node.entry);
+    }
+    for (uint32_t child = node.first_child; child != NONE; child = m_nodes[child].next_sibling) {
+        const Node& c = m_nodes[child];
+        candidates.insert(candidates.end(), c.top.begin(), c.top.begin() + c.top_count);
+    }
+
+    size_t count = std::min(candidates.size(), MAX_RESULTS);
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+        [this](uint32_t a, uint32_t b) { return Better(a, b); });
+
+    Node& target = m_nodes[index];
+    std::copy(candidates.begin(), candidates.begin() + count, target.top.begin());
+    target.top_count = static_cast<uint8_t>(count);
+}
+
+void CompletionIndex::RebuildPath()
+{
+    // Deepest first, so each node merges its children's updated lists
+    for (size_t i = m_path.size(); i-- > 0;) {
+        Rebuild(m_path[i]);
+    }
+}
+
+} // namespace Tatoosh
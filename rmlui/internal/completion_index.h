@@ -0,0 +1,97 @@
+/*
+ * Tatoosh - Completion Index
+ *
+ * Prefix trie over the engine's command, cvar and alias names, for
+ * as-you-type completion. Names are added as the engine registers them, so
+ * the index is never rebuilt. Matching ignores case.
+ *
+ * Every node keeps the MAX_RESULTS best names of its subtree, best first.
+ * A query walks the prefix and copies that list, so its cost depends on the
+ * prefix length, not on how many names exist. Names are ranked by console
+ * use, then by length (the closest completion first), then by kind and name.
+ */
+
+#ifndef TATOOSH_COMPLETION_INDEX_H
+#define TATOOSH_COMPLETION_INDEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../types/completion_kind.h"
+#include "../types/cvar_provider.h"
+
+namespace Tatoosh {
+
+class CompletionIndex {
+public:
+    static constexpr size_t MAX_RESULTS = 8;
+
+    struct Entry {
+        std::string name;           // As registered
+        ui_completion_kind_t kind;
+        uint32_t uses;              // Times run from the console
+        mutable CvarRef cvar;       // Cvars: resolved on first display
+    };
+
+    CompletionIndex();
+
+    // Add a name, or change the kind of one already indexed.
+    // O(length * MAX_RESULTS).
+    void Insert(const char* name, ui_completion_kind_t kind);
+    void Remove(const char* name);
+
+    // Count a use of the name, ranking it higher
+    void RecordUse(const char* name);
+
+    // Best names starting with prefix, best first. Returns the number
+    // written, at most min(max_results, MAX_RESULTS). Entries stay valid
+    // until the next Insert or Remove.
+    size_t Complete(const char* prefix, const Entry** results, size_t max_results) const;
+
+    const Entry* Find(const char* name) const;
+    size_t Size() const { return m_count; }
+    void Clear();
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        uint32_t first_child = NONE;   // Siblings sorted by key
+        uint32_t next_sibling = NONE;
+        uint32_t entry = NONE;         // Name ending here
+        uint8_t key = 0;
+        uint8_t top_count = 0;
+        std::array<uint32_t, MAX_RESULTS> top;
+    };
+
+    uint32_t FindChild(uint32_t node, uint8_t key) const;
+    uint32_t AddChild(uint32_t node, uint8_t key);
+
+    // Walk a name, filling m_path with root..end. NONE if it isn't indexed.
+    uint32_t WalkPath(const char* name);
+    uint32_t FindNode(const char* name) const;
+
+    bool Better(uint32_t a, uint32_t b) const;
+
+    // Entry's rank only went up: move or insert it in the node's list
+    void Promote(Node& node, uint32_t entry);
+
+    // Recompute the node's list from its own entry and its children's lists
+    void Rebuild(uint32_t node);
+    void RebuildPath();
+
+    std::vector<Node> m_nodes;          // [0] is the root
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_free;       // Entries of removed names
+    std::vector<uint32_t> m_path;       // Scratch
+    size_t m_count;
+};
+
+// Commands, cvars and aliases, fed by UI_CompletionAdd from engine startup on
+extern CompletionIndex g_completion_index;
+
+} // namespace Tatoosh
+
+#endif // TATOOSH_COMPLETION_INDEX_H
@@ -0,0 +1,66 @@
+/*
+ * Tatoosh - Console Buffer Implementation
+ */
+
+#include "console_buffer.h"
+#include <algorithm>
+
+namespace Tatoosh {
+
+ConsoleBuffer::ConsoleBuffer(size_t max_lines)
+    : m_chunk_first(0)
+    , m_chunk_count(0)
+    , m_first_line(0)
+    , m_end_line(0)
+{
+    // Two chunks at least, so evicting never drops the chunk being written
+    size_t chunks = (max_lines + LINES_PER_CHUNK - 1) / LINES_PER_CHUNK;
+    m_chunks.resize(std::max<size_t>(chunks, 2));
+}
+
+void ConsoleBuffer::Append(const char* text, size_t length)
+{
+    if (m_chunk_count == 0 || ChunkAt(m_chunk_count - 1).ends.size() == LINES_PER_CHUNK) {
+        if (m_chunk_count == m_chunks.size()) {
+            // Reused below as the newest chunk
+            m_chunk_first = (m_chunk_first + 1) % m_chunks.size();
+            m_chunk_count--;
+            m_first_line += LINES_PER_CHUNK;
+        }
+
+        Chunk& chunk = ChunkAt(m_chunk_count);
+        chunk.text.clear();
+        chunk.ends.clear();
+        chunk.ends.reserve(LINES_PER_CHUNK);
+        m_chunk_count++;
+    }
+
+    Chunk& chunk = ChunkAt(m_chunk_count - 1);
+    chunk.text.append(text, length);
+    chunk.ends.push_back(static_cast<uint32_t>(chunk.text.size()));
+    m_end_line++;
+}
+
+void ConsoleBuffer::Clear()
+{
+    // Chunks keep their allocations for reuse
+    m_chunk_first = 0;
+    m_chunk_count = 0;
+    m_first_line = m_end_line;
+}
+
+std::string_view ConsoleBuffer::Line(uint64_t line) const
+{
+    if (line < m_first_line || line >= m_end_line) {
+        return std::string_view();
+    }
+
+    uint64_t offset = line - m_first_line;
+    const Chunk& chunk = ChunkAt(static_cast<size_t>(offset / LINES_PER_CHUNK));
+    size_t index = static_cast<size_t>(offset % LINES_PER_CHUNK);
+
+    uint32_t start = index > 0 ? chunk.ends[index - 1] : 0;
+    return std::string_view(chunk.text.data() + start, chunk.ends[index] - start);
+}
+
+} // namespace Tatoosh
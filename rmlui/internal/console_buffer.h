@@ -0,0 +1,63 @@
+/*
+ * Tatoosh - Console Buffer
+ *
+ * Scrollback for the RmlUI console. Lines are packed into fixed-size chunks,
+ * each one text arena plus the end offset of every line, held in a ring of
+ * chunks. Lines are addressed by absolute number, so a position stays valid
+ * while newer lines arrive. Lookup is O(1). When the ring is full, the
+ * oldest chunk is cleared and reused for the newest lines, keeping its
+ * allocations.
+ */
+
+#ifndef TATOOSH_CONSOLE_BUFFER_H
+#define TATOOSH_CONSOLE_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Tatoosh {
+
+class ConsoleBuffer {
+public:
+    static constexpr size_t LINES_PER_CHUNK = 1024;
+    static constexpr size_t DEFAULT_CAPACITY = 128 * 1024;   // Lines
+
+    explicit ConsoleBuffer(size_t max_lines = DEFAULT_CAPACITY);
+
+    // Store one complete line, without its newline. Amortized O(length).
+    void Append(const char* text, size_t length);
+    void Clear();
+
+    // Absolute numbers of the oldest line held and one past the newest
+    uint64_t FirstLine() const { return m_first_line; }
+    uint64_t EndLine() const { return m_end_line; }
+    size_t Size() const { return static_cast<size_t>(m_end_line - m_first_line); }
+    size_t GetCapacity() const { return m_chunks.size() * LINES_PER_CHUNK; }
+
+    // Text of an absolute line; empty once it has been evicted. Valid until
+    // the next Append or Clear.
+    std::string_view Line(uint64_t line) const;
+
+private:
+    struct Chunk {
+        std::string text;
+        std::vector<uint32_t> ends;   // Line i is text[ends[i - 1], ends[i])
+    };
+
+    Chunk& ChunkAt(size_t index) { return m_chunks[(m_chunk_first + index) % m_chunks.size()]; }
+    const Chunk& ChunkAt(size_t index) const { return m_chunks[(m_chunk_first + index) % m_chunks.size()]; }
+
+    std::vector<Chunk> m_chunks;   // Ring; every chunk but the newest is full
+    size_t m_chunk_first;
+    size_t m_chunk_count;
+
+    uint64_t m_first_line;         // First line of the oldest chunk
+    uint64_t m_end_line;
+};
+
+} // namespace Tatoosh
+
+#endif // TATOOSH_CONSOLE_BUFFER_H
@@ -0,0 +1,642 @@
+/*
+ * Tatoosh - Console Model Implementation
+ */
+
+#include "console_model.h"
+#include "console_buffer.h"
+#include "completion_index.h"
+#include "cvar_binding.h"
+#include "menu_event_handler.h"
+#include "model_subscriptions.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+extern "C" {
+    void Con_Printf(const char* fmt, ...);
+}
+
+namespace Tatoosh {
+
+namespace {
+
+constexpr uint64_t NO_MATCH = std::numeric_limits<uint64_t>::max();
+
+// Output and everything that reads it. Con_Printf may run on worker threads.
+ConsoleBuffer s_buffer;
+std::string s_partial;
+std::mutex s_mutex;
+
+// Bound values — RmlUI binds to these pointers
+std::vector<ConsoleRow> s_rows;
+Rml::String s_input;
+Rml::String s_search;
+Rml::String s_search_status;
+int s_lines_below = 0;
+std::vector<ConsoleCompletion> s_completions;
+
+// Variable names, built once
+const Rml::String VAR_ROWS = "rows";
+const Rml::String VAR_INPUT = "input";
+const Rml::String VAR_SEARCH = "search";
+const Rml::String VAR_SEARCH_STATUS = "search_status";
+const Rml::String VAR_LINES_BELOW = "lines_below";
+const Rml::String VAR_COMPLETIONS = "completions";
+
+const Rml::String KIND_NAMES[] = {"command", "cvar", "alias"};
+
+const Rml::String LOG_ELEMENT_ID = "console-log";
+const Rml::String INPUT_ELEMENT_ID = "console-input";
+const Rml::String SEARCH_ELEMENT_ID = "console-search";
+
+// query is already lowercase
+bool ContainsNoCase(std::string_view text, const std::string& query)
+{
+    auto it = std::search(text.begin(), text.end(), query.begin(), query.end(),
+        [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == b;
+        });
+    return it != text.end();
+}
+
+} // namespace
+
+// Static members
+ConsoleModel::InputListener ConsoleModel::s_listener;
+Rml::Context* ConsoleModel::s_context = nullptr;
+Rml::DataModelHandle ConsoleModel::s_model_handle;
+Rml::ObserverPtr<Rml::Element> ConsoleModel::s_log_element;
+bool ConsoleModel::s_initialized = false;
+uint64_t ConsoleModel::s_view_end = 0;
+bool ConsoleModel::s_follow = true;
+int ConsoleModel::s_viewport_rows = ConsoleModel::DEFAULT_VIEWPORT_ROWS;
+bool ConsoleModel::s_rows_dirty = true;
+std::string ConsoleModel::s_query;
+uint64_t ConsoleModel::s_search_cursor = 0;
+uint64_t ConsoleModel::s_search_match = NO_MATCH;
+bool ConsoleModel::s_searching = false;
+size_t ConsoleModel::s_completion_start = 0;
+int ConsoleModel::s_completion_selected = 0;
+
+bool ConsoleModel::Initialize(Rml::Context* context)
+{
+    if (s_initialized) {
+        Con_Printf("ConsoleModel: Already initialized\n");
+        return true;
+    }
+
+    if (!context) {
+        Con_Printf("ConsoleModel: ERROR - null context\n");
+        return false;
+    }
+
+    Rml::DataModelConstructor constructor = context->CreateDataModel("console");
+    if (!constructor) {
+        Con_Printf("ConsoleModel: ERROR - Failed to create data model\n");
+        return false;
+    }
+
+    if (auto row = constructor.RegisterStruct<ConsoleRow>()) {
+        row.RegisterMember("text", &ConsoleRow::text);
+        row.RegisterMember("match", &ConsoleRow::match);
+    }
+    constructor.RegisterArray<std::vector<ConsoleRow>>();
+
+    if (auto completion = constructor.RegisterStruct<ConsoleCompletion>()) {
+        completion.RegisterMember("name", &ConsoleCompletion::name);
+        completion.RegisterMember("kind", &ConsoleCompletion::kind);
+        completion.RegisterMember("value", &ConsoleCompletion::value);
+        completion.RegisterMember("selected", &ConsoleCompletion::selected);
+    }
+    constructor.RegisterArray<std::vector<ConsoleCompletion>>();
+
+    // Rows of the viewport, top to bottom: data-for="row : rows"
+    constructor.Bind(VAR_ROWS, &s_rows);
+    constructor.Bind(VAR_INPUT, &s_input);
+    constructor.Bind(VAR_SEARCH, &s_search);
+    constructor.Bind(VAR_SEARCH_STATUS, &s_search_status);
+    constructor.Bind(VAR_LINES_BELOW, &s_lines_below);
+    constructor.Bind(VAR_COMPLETIONS, &s_completions);
+
+    s_model_handle = constructor.GetModelHandle();
+    s_context = context;
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_rows.resize(s_viewport_rows);
+        s_rows_dirty = true;
+    }
+
+    // Rows are only rebuilt while the console is showing
+    ModelSubscriptions::Register("console", &ConsoleModel::MarkAllDirty);
+
+    s_initialized = true;
+
+    Con_Printf("ConsoleModel: Initialized (%u line scrollback)\n",
+               static_cast<unsigned>(s_buffer.GetCapacity()));
+    return true;
+}
+
+void ConsoleModel::Shutdown()
+{
+    if (!s_initialized) return;
+
+    ModelSubscriptions::Unregister("console");
+
+    // The scrollback outlives the UI, like the engine console's
+    s_rows.clear();
+    s_input.clear();
+    s_search.clear();
+    s_search_status.clear();
+    s_completions.clear();
+    s_model_handle = Rml::DataModelHandle();
+    s_log_element = Rml::ObserverPtr<Rml::Element>();
+    s_context = nullptr;
+    s_initialized = false;
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_query.clear();
+        s_search_match = NO_MATCH;
+        s_searching = false;
+        s_follow = true;
+    }
+
+    Con_Printf("ConsoleModel: Shutdown\n");
+}
+
+bool ConsoleModel::IsInitialized()
+{
+    return s_initialized;
+}
+
+void ConsoleModel::Print(const char* text)
+{
+    if (!text) return;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    for (const char* c = text; *c; ++c) {
+        // The high bit marks Quake's coloured text
+        char ch = static_cast<char>(*c & 0x7f);
+
+        if (ch == '\n') {
+            AppendLine(s_partial.data(), s_partial.size());
+            s_partial.clear();
+            continue;
+        }
+        if (ch == '\t') {
+            ch = ' ';
+        } else if (static_cast<unsigned char>(ch) < 32) {
+            continue;   // '\r' and the \1 / \2 message markers
+        }
+
+        s_partial.push_back(ch);
+        if (s_partial.size() >= MAX_LINE_LENGTH) {
+            AppendLine(s_partial.data(), s_partial.size());
+            s_partial.clear();
+        }
+    }
+}
+
+void ConsoleModel::AppendLine(const char* text, size_t length)
+{
+    s_buffer.Append(text, length);
+
+    // A scrolled-back view stays on its lines; Update only moves lines_below
+    if (s_follow) {
+        s_rows_dirty = true;
+    }
+}
+
+void ConsoleModel::Update()
+{
+    if (!s_initialized || !s_model_handle) return;
+
+    if (!s_log_element) {
+        AttachDocument();
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    FitViewport();
+    ClampView();
+
+    if (s_searching) {
+        StepSearch();
+    }
+
+    int below = static_cast<int>(std::min<uint64_t>(s_buffer.EndLine() - s_view_end,
+                                                    std::numeric_limits<int>::max()));
+    if (below != s_lines_below) {
+        s_lines_below = below;
+        s_model_handle.DirtyVariable(VAR_LINES_BELOW);
+    }
+
+    if (s_rows_dirty) {
+        RebuildRows();
+    }
+}
+
+void ConsoleModel::AttachDocument()
+{
+    if (!s_context) return;
+
+    for (int i = 0; i < s_context->GetNumDocuments(); ++i) {
+        Rml::ElementDocument* document = s_context->GetDocument(i);
+        Rml::Element* log = document ? document->GetElementById(LOG_ELEMENT_ID) : nullptr;
+        if (!log) continue;
+
+        // A reloaded document is a new element; the old one took its
+        // listeners with it
+        s_log_element = log->GetObserverPtr();
+        document->AddEventListener(Rml::EventId::Keydown, &s_listener);
+        document->AddEventListener(Rml::EventId::Change, &s_listener);
+        document->AddEventListener(Rml::EventId::Mousescroll, &s_listener);
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_rows_dirty = true;
+        return;
+    }
+}
+
+void ConsoleModel::FitViewport()
+{
+    if (!s_log_element) return;
+
+    // Rows are a single line each, so the count follows from the log height
+    float height = s_log_element->GetClientHeight();
+    float line_height = s_log_element->GetLineHeight();
+    if (height <= 0.0f || line_height <= 0.0f) return;
+
+    int rows = std::clamp(static_cast<int>(height / line_height), 1, MAX_VIEWPORT_ROWS);
+    if (rows == s_viewport_rows) return;
+
+    // Changing the array length is the only thing that adds or removes row
+    // elements
+    s_viewport_rows = rows;
+    s_rows.resize(rows);
+    s_rows_dirty = true;
+}
+
+void ConsoleModel::ClampView()
+{
+    uint64_t end = s_buffer.EndLine();
+
+    if (s_follow || s_view_end >= end) {
+        if (s_view_end != end) {
+            s_view_end = end;
+            s_rows_dirty = true;
+        }
+        s_follow = true;
+        return;
+    }
+
+    // Eviction can pull the oldest line past the top of the view
+    uint64_t lowest = std::min(end, s_buffer.FirstLine() + s_viewport_rows);
+    if (s_view_end < lowest) {
+        s_view_end = lowest;
+        s_rows_dirty = true;
+    }
+}
+
+void ConsoleModel::RebuildRows()
+{
+    uint64_t first = s_buffer.FirstLine();
+
+    for (int i = 0; i < s_viewport_rows; ++i) {
+        // Newest line at the bottom; rows above the oldest line are blank
+        uint64_t offset = static_cast<uint64_t>(s_viewport_rows - i);
+        ConsoleRow& row = s_rows[i];
+
+        if (s_view_end < offset || s_view_end - offset < first) {
+            row.text.clear();
+            row.match = false;
+            continue;
+        }
+
+        uint64_t line = s_view_end - offset;
+        std::string_view text = s_buffer.Line(line);
+        row.text.assign(text.data(), text.size());
+        row.match = (line == s_search_match);
+    }
+
+    s_rows_dirty = false;
+    s_model_handle.DirtyVariable(VAR_ROWS);
+}
+
+void ConsoleModel::Scroll(int lines)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    uint64_t end = s_buffer.EndLine();
+    if (s_follow) {
+        s_view_end = end;
+    }
+
+    uint64_t lowest = std::min(end, s_buffer.FirstLine() + s_viewport_rows);
+    uint64_t target = s_view_end;
+    if (lines > 0) {
+        uint64_t up = static_cast<uint64_t>(lines);
+        target = (target > lowest + up) ? target - up : lowest;
+    } else if (lines < 0) {
+        uint64_t down = static_cast<uint64_t>(-static_cast<int64_t>(lines));
+        target = (target + down < end) ? target + down : end;
+    }
+
+    if (target != s_view_end) {
+        s_view_end = target;
+        s_rows_dirty = true;
+    }
+    s_follow = (s_view_end == end);
+}
+
+void ConsoleModel::ScrollToBottom()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if (!s_follow) {
+        s_follow = true;
+        s_rows_dirty = true;
+    }
+}
+
+void ConsoleModel::Find(const std::string& query)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        s_query.resize(query.size());
+        std::transform(query.begin(), query.end(), s_query.begin(),
+            [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+        if (s_search_match != NO_MATCH) {
+            s_rows_dirty = true;
+        }
+        s_search_match = NO_MATCH;
+        s_search_cursor = s_follow ? s_buffer.EndLine() : s_view_end;
+        s_searching = !s_query.empty();
+    }
+
+    SetSearchStatus(query.empty() ? "" : "Searching...");
+}
+
+void ConsoleModel::FindNext()
+{
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        if (s_query.empty()) return;
+
+        if (s_search_match != NO_MATCH) {
+            s_search_cursor = s_search_match;
+        } else {
+            s_search_cursor = s_follow ? s_buffer.EndLine() : s_view_end;
+        }
+        s_searching = true;
+    }
+
+    SetSearchStatus("Searching...");
+}
+
+void ConsoleModel::StepSearch()
+{
+    uint64_t first = s_buffer.FirstLine();
+    uint64_t end = s_buffer.EndLine();
+    s_search_cursor = std::min(s_search_cursor, end);
+
+    for (int n = 0; n < SEARCH_LINES_PER_FRAME; ++n) {
+        if (s_search_cursor <= first) {
+            s_searching = false;
+            SetSearchStatus(s_search_match == NO_MATCH ? "No matches" : "No older matches");
+            return;
+        }
+
+        uint64_t line = --s_search_cursor;
+        if (!ContainsNoCase(s_buffer.Line(line), s_query)) continue;
+
+        // Bring the match to the middle of the view
+        s_search_match = line;
+        s_searching = false;
+        s_view_end = std::min(end, line + 1 + s_viewport_rows / 2);
+        s_follow = (s_view_end == end);
+        ClampView();
+        s_rows_dirty = true;
+
+        SetSearchStatus(std::to_string(end - line) + " lines up");
+        return;
+    }
+}
+
+void ConsoleModel::SetSearchStatus(const Rml::String& status)
+{
+    if (status == s_search_status) return;
+
+    s_search_status = status;
+    if (s_model_handle) {
+        s_model_handle.DirtyVariable(VAR_SEARCH_STATUS);
+    }
+}
+
+void ConsoleModel::Submit(const std::string& command)
+{
+    size_t start = command.find_first_not_of(" \t");
+    if (start == std::string::npos) return;
+    std::string trimmed = command.substr(start);
+
+    s_input.clear();
+    if (s_model_handle) {
+        s_model_handle.DirtyVariable(VAR_INPUT);
+    }
+    ClearCompletions();
+    ScrollToBottom();
+
+    // Names run from the console rank higher in later completions
+    std::string name = trimmed.substr(0, trimmed.find_first_of(" \t;"));
+    g_completion_index.RecordUse(name.c_str());
+
+    // Echoed through the engine like its own console, which reaches Print
+    Con_Printf("]%s\n", trimmed.c_str());
+    MenuEventHandler::GetExecutor()->Execute(trimmed);
+}
+
+void ConsoleModel::Complete(const std::string& input)
+{
+    // Only the first word of the last command on the line is completed
+    size_t start = input.rfind(';');
+    start = (start == std::string::npos) ? 0 : start + 1;
+    start = input.find_first_not_of(" \t", start);
+    if (start == std::string::npos || input.find_first_of(" \t", start) != std::string::npos) {
+        ClearCompletions();
+        return;
+    }
+
+    const CompletionIndex::Entry* results[CompletionIndex::MAX_RESULTS];
+    size_t count = g_completion_index.Complete(input.c_str() + start, results,
+                                               CompletionIndex::MAX_RESULTS);
+    if (count == 0) {
+        ClearCompletions();
+        return;
+    }
+
+    ICvarProvider* provider = CvarBindingManager::GetProvider();
+
+    s_completion_start = start;
+    s_completion_selected = 0;
+    s_completions.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const CompletionIndex::Entry& entry = *results[i];
+        ConsoleCompletion& completion = s_completions[i];
+        completion.name = entry.name;
+        completion.kind = KIND_NAMES[entry.kind];
+        completion.selected = (i == 0);
+        completion.value.clear();
+
+        if (entry.kind == UI_COMPLETION_CVAR && provider) {
+            if (!entry.cvar) {
+                entry.cvar = provider->Find(entry.name.c_str());
+            }
+            if (entry.cvar) {
+                completion.value = provider->GetString(entry.cvar);
+            }
+        }
+    }
+
+    if (s_model_handle) {
+        s_model_handle.DirtyVariable(VAR_COMPLETIONS);
+    }
+}
+
+bool ConsoleModel::AcceptCompletion()
+{
+    if (s_completions.empty()) return false;
+
+    const ConsoleCompletion& completion = s_completions[s_completion_selected];
+    s_input = s_input.substr(0, s_completion_start) + completion.name + " ";
+    if (s_model_handle) {
+        s_model_handle.DirtyVariable(VAR_INPUT);
+    }
+
+    ClearCompletions();
+    return true;
+}
+
+bool ConsoleModel::MoveCompletionSelection(int delta)
+{
+    if (s_completions.empty()) return false;
+
+    int count = static_cast<int>(s_completions.size());
+    s_completions[s_completion_selected].selected = false;
+    s_completion_selected = ((s_completion_selected + delta) % count + count) % count;
+    s_completions[s_completion_selected].selected = true;
+
+    if (s_model_handle) {
+        s_model_handle.DirtyVariable(VAR_COMPLETIONS);
+    }
+    return true;
+}
+
+void ConsoleModel::ClearCompletions()
+{
+    if (s_completions.empty()) return;
+
+    s_completions.clear();
+    s_completion_selected = 0;
+    if (s_model_handle) {
+        s_model_handle.DirtyVariable(VAR_COMPLETIONS);
+    }
+}
+
+void ConsoleModel::MarkAllDirty()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_rows_dirty = true;
+}
+
+void ConsoleModel::InputListener::ProcessEvent(Rml::Event& event)
+{
+    Rml::Element* target = event.GetTargetElement();
+    if (!target) return;
+
+    switch (event.GetId()) {
+    case Rml::EventId::Mousescroll: {
+        float delta = event.GetParameter<float>("wheel_delta_y", 0.0f);
+        int lines = static_cast<int>(std::lround(delta * WHEEL_LINES));
+        if (lines != 0) {
+            ConsoleModel::Scroll(-lines);
+        }
+        event.StopPropagation();
+        break;
+    }
+
+    case Rml::EventId::Change:
+        // Search and complete as you type
+        if (target->GetId() == SEARCH_ELEMENT_ID) {
+            ConsoleModel::Find(target->GetAttribute<Rml::String>("value", ""));
+        } else if (target->GetId() == INPUT_ELEMENT_ID) {
+            s_input = target->GetAttribute<Rml::String>("value", "");
+            ConsoleModel::Complete(s_input);
+        }
+        break;
+
+    case Rml::EventId::Keydown: {
+        int key = event.GetParameter<int>("key_identifier", 0);
+        bool ctrl = event.GetParameter<int>("ctrl_key", 0) != 0;
+        int page = std::max(1, s_viewport_rows - 1);
+
+        bool handled = true;
+        switch (key) {
+        case Rml::Input::KI_PRIOR:
+            ConsoleModel::Scroll(page);
+            break;
+        case Rml::Input::KI_NEXT:
+            ConsoleModel::Scroll(-page);
+            break;
+        case Rml::Input::KI_HOME:
+            handled = ctrl;
+            if (ctrl) ConsoleModel::Scroll(std::numeric_limits<int>::max());
+            break;
+        case Rml::Input::KI_END:
+            handled = ctrl;
+            if (ctrl) ConsoleModel::ScrollToBottom();
+            break;
+        case Rml::Input::KI_TAB:
+            handled = target->GetId() == INPUT_ELEMENT_ID && ConsoleModel::AcceptCompletion();
+            break;
+        case Rml::Input::KI_UP:
+            handled = ConsoleModel::MoveCompletionSelection(-1);
+            break;
+        case Rml::Input::KI_DOWN:
+            handled = ConsoleModel::MoveCompletionSelection(1);
+            break;
+        case Rml::Input::KI_RETURN:
+        case Rml::Input::KI_NUMPADENTER:
+            if (target->GetId() == INPUT_ELEMENT_ID) {
+                ConsoleModel::Submit(target->GetAttribute<Rml::String>("value", ""));
+            } else if (target->GetId() == SEARCH_ELEMENT_ID) {
+                ConsoleModel::FindNext();
+            } else {
+                handled = false;
+            }
+            break;
+        default:
+            handled = false;
+            break;
+        }
+
+        if (handled) {
+            event.StopPropagation();
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+} // namespace Tatoosh
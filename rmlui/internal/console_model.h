@@ -0,0 +1,132 @@
+/*
+ * Tatoosh - Console Model
+ *
+ * The engine console as an RmlUI document. Console output is kept in a
+ * ConsoleBuffer of 128k lines. The "console" data model exposes only the
+ * rows that fit the viewport, so the document holds one element per
+ * visible row however long the history is. Scrolling rewrites the text of
+ * those rows in place. Resizing changes their count to the new viewport
+ * height. A search scans a fixed number of lines per frame until it finds
+ * a match, so no frame scans the whole history.
+ *
+ * As the command line is edited, its first word is looked up in the
+ * completion index. Tab accepts the selected completion; Up and Down move
+ * the selection.
+ *
+ * Usage in RML:
+ *   <body data-model="console">
+ *     <div id="console-log">
+ *       <div class="console-line" data-for="row : rows"
+ *            data-class-match="row.match">{{ row.text }}</div>
+ *     </div>
+ *     <input id="console-input" type="text" data-value="input"/>
+ *   </body>
+ */
+
+#ifndef TATOOSH_CONSOLE_MODEL_H
+#define TATOOSH_CONSOLE_MODEL_H
+
+#include <RmlUi/Core.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Tatoosh {
+
+// One visible row of the console log
+struct ConsoleRow {
+    Rml::String text;
+    bool match = false;   // Current search result
+};
+
+// One completion of the word being typed
+struct ConsoleCompletion {
+    Rml::String name;
+    Rml::String kind;     // "command", "cvar" or "alias"
+    Rml::String value;    // Cvars: current value
+    bool selected = false;
+};
+
+class ConsoleModel {
+public:
+    static constexpr int DEFAULT_VIEWPORT_ROWS = 24;
+    static constexpr int MAX_VIEWPORT_ROWS = 256;
+    static constexpr size_t MAX_LINE_LENGTH = 1024;     // Longer output wraps
+    static constexpr int SEARCH_LINES_PER_FRAME = 8192;
+    static constexpr int WHEEL_LINES = 3;
+
+    // Create the "console" data model. Output printed before this is kept.
+    static bool Initialize(Rml::Context* context);
+    static void Shutdown();
+
+    // Console output, any fragment: lines are split on '\n' and a partial
+    // line waits for the rest. Safe to call from any thread.
+    static void Print(const char* text);
+
+    // Per frame while the console document is visible: fit the row count to
+    // the viewport, advance a running search and refresh the rows
+    static void Update();
+
+    // Positive scrolls toward older lines
+    static void Scroll(int lines);
+    static void ScrollToBottom();
+
+    // Search backwards from the bottom of the view. An empty query clears.
+    static void Find(const std::string& query);
+
+    // Continue the search past the current match
+    static void FindNext();
+
+    // Execute the input line and echo it to the log
+    static void Submit(const std::string& command);
+
+    // Look up completions for the command line being edited
+    static void Complete(const std::string& input);
+
+    // Replace the word being typed with the selected completion
+    static bool AcceptCompletion();
+    static bool MoveCompletionSelection(int delta);
+
+    // Re-read everything on the next Update (catch-up after being hidden)
+    static void MarkAllDirty();
+
+    static bool IsInitialized();
+
+private:
+    static void AppendLine(const char* text, size_t length);
+    static void AttachDocument();
+    static void FitViewport();
+    static void ClampView();
+    static void StepSearch();
+    static void RebuildRows();
+    static void SetSearchStatus(const Rml::String& status);
+    static void ClearCompletions();
+
+    class InputListener : public Rml::EventListener {
+    public:
+        void ProcessEvent(Rml::Event& event) override;
+    };
+
+    static InputListener s_listener;
+    static Rml::Context* s_context;
+    static Rml::DataModelHandle s_model_handle;
+    static Rml::ObserverPtr<Rml::Element> s_log_element;
+    static bool s_initialized;
+
+    static uint64_t s_view_end;      // One past the bottom visible line
+    static bool s_follow;            // View sticks to the newest line
+    static int s_viewport_rows;
+    static bool s_rows_dirty;
+
+    static std::string s_query;      // Lowercase
+    static uint64_t s_search_cursor; // Next line to test, scanning backwards
+    static uint64_t s_search_match;  // UINT64_MAX: none
+    static bool s_searching;
+
+    static size_t s_completion_start;   // Where the completed word begins
+    static int s_completion_selected;
+};
+
+} // namespace Tatoosh
+
+#endif // TATOOSH_CONSOLE_MODEL_H
@@ -8,7 +8,9 @@
 #include "quake_cvar_provider.h"
 
 #include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <cstdlib>
 
 extern "C" {
     void Con_Printf(const char* fmt, ...);
@@ -19,10 +21,18 @@ namespace Tatoosh {
 // Static member definitions
 Rml::Context* CvarBindingManager::s_context = nullptr;
 Rml::DataModelHandle CvarBindingManager::s_model_handle;
+std::unordered_map<std::string, CvarBinding> CvarBindingManager::s_schema;
 std::unordered_map<std::string, CvarBinding> CvarBindingManager::s_bindings;
 std::unordered_map<std::string, std::unique_ptr<float>> CvarBindingManager::s_float_values;
 std::unordered_map<std::string, std::unique_ptr<int>> CvarBindingManager::s_int_values;
 std::unordered_map<std::string, std::unique_ptr<Rml::String>> CvarBindingManager::s_string_values;
+std::vector<CvarBindingManager::SyncEntry> CvarBindingManager::s_sync_entries;
+std::unordered_map<std::string, size_t> CvarBindingManager::s_entry_index;
+std::unordered_map<std::string, std::vector<size_t>> CvarBindingManager::s_entries_by_cvar;
+std::vector<size_t> CvarBindingManager::s_pending;
+std::vector<size_t> CvarBindingManager::s_staged;
+bool CvarBindingManager::s_change_notifications = false;
+const std::string* CvarBindingManager::s_writing_ui_name = nullptr;
 bool CvarBindingManager::s_initialized = false;
 ICvarProvider* CvarBindingManager::s_provider = nullptr;
 bool CvarBindingManager::s_ignore_ui_changes = false;
@@ -86,181 +96,232 @@ bool CvarBindingManager::Initialize(Rml::Context* context)
         return false;
     }
 
+    // Lets a menu show that it has unapplied settings
+    constructor.BindFunc("settings_pending",
+        [](Rml::Variant& variant) { variant = !s_staged.empty(); });
+
     s_model_handle = constructor.GetModelHandle();
     s_context = context;
     s_initialized = true;
 
-    RegisterAllBindings();
-
-    Con_Printf("CvarBindingManager: Initialized with %zu bindings\n", s_bindings.size());
+    Con_Printf("CvarBindingManager: Initialized\n");
     return true;
 }
 
-void CvarBindingManager::RegisterAllBindings()
+bool CvarBindingManager::LoadSchema(const std::string& path)
 {
-    // ── Float cvars (sliders with data-value + cvar_changed) ──
-
-    // Graphics
-    RegisterFloat("fov",          "fov",        50.0f, 130.0f, 5.0f);
-    RegisterFloat("gamma",        "gamma",      0.5f,  2.0f,   0.05f);
-    RegisterFloat("contrast",     "contrast",   0.5f,  2.0f,   0.05f);
-    RegisterFloat("host_maxfps",  "max_fps",    30.0f, 1000.0f, 10.0f);
-
-    // Sound
-    RegisterFloat("volume",       "volume",     0.0f, 1.0f, 0.05f);
-    RegisterFloat("bgmvolume",    "bgmvolume",  0.0f, 1.0f, 0.05f);
-
-    // Game / Controls
-    RegisterFloat("sensitivity",  "sensitivity", 1.0f, 20.0f, 0.5f);
-    RegisterFloat("scr_sbaralpha","hud_opacity", 0.0f, 1.0f, 0.05f);
-    RegisterFloat("scr_uiscale",  "ui_scale",   0.5f, 3.0f,  0.25f);
-    RegisterFloat("cl_bob",       "view_bob",   0.0f, 0.05f, 0.005f);
-    RegisterFloat("cl_rollangle", "view_roll",  0.0f, 5.0f,  0.5f);
-
-    // ── Bool cvars (cycle_cvar toggles) ──
-
-    // Graphics
-    RegisterBool("vid_fullscreen",   "fullscreen");
-    RegisterBool("vid_vsync",        "vsync");
-    RegisterBool("vid_palettize",    "palettize");
-    RegisterBool("r_dynamic",        "dynamic_lights");
-    RegisterBool("r_waterwarp",      "underwater_fx");
-    RegisterBool("r_lerpmodels",     "model_interpolation");
-
-    // Game / Controls
-    RegisterBool("m_pitch",          "invert_mouse");  // special: sign-based
-    RegisterBool("cl_alwaysrun",     "always_run");
-    RegisterBool("m_filter",         "m_filter");
-    RegisterBool("r_drawviewmodel",  "show_gun");
-    RegisterBool("cl_startdemos",    "startup_demos");
-
-    // ── Enum cvars (cycle_cvar with display labels) ──
-
-    // Graphics — texture quality (gl_picmip: 0=High, 1=Medium, 2=Low)
-    {
-        const char* labels[] = {"High", "Medium", "Low"};
-        RegisterEnum("gl_picmip", "texture_quality", 3, labels);
+    Rml::FileInterface* file_interface = Rml::GetFileInterface();
+    Rml::FileHandle file = file_interface ? file_interface->Open(path) : 0;
+    if (!file) {
+        Con_Printf("CvarBindingManager: ERROR - Cannot open schema '%s'\n", path.c_str());
+        return false;
     }
 
-    // Graphics — texture filter (vid_filter: 0=Smooth, 1=Classic)
-    {
-        const char* labels[] = {"Smooth", "Classic"};
-        RegisterEnum("vid_filter", "texture_filter", 2, labels);
+    std::string source(file_interface->Length(file), '\0');
+    source.resize(file_interface->Read(&source[0], source.size(), file));
+    file_interface->Close(file);
+
+    size_t errors = 0;
+    int line_number = 0;
+    size_t line_start = 0;
+    while (line_start < source.size()) {
+        size_t line_end = source.find('\n', line_start);
+        if (line_end == std::string::npos) line_end = source.size();
+        line_number++;
+
+        std::vector<std::string> tokens = TokenizeSchemaLine(source, line_start, line_end);
+        line_start = line_end + 1;
+        if (tokens.empty()) continue;
+
+        CvarBinding binding;
+        if (!ParseSchemaEntry(tokens, binding)) {
+            Con_Printf("CvarBindingManager: %s:%d: invalid binding '%s'\n",
+                       path.c_str(), line_number, tokens[0].c_str());
+            errors++;
+            continue;
+        }
+        s_schema[binding.ui_name] = std::move(binding);
     }
 
-    // Graphics — anisotropy (vid_anisotropic: 1, 2, 4, 8, 16)
-    {
-        std::vector<int> values = {1, 2, 4, 8, 16};
-        const char* labels[] = {"Off", "2x", "4x", "8x", "16x"};
-        RegisterEnumValues("vid_anisotropic", "aniso", values, labels);
-    }
+    Con_Printf("CvarBindingManager: Loaded %zu bindings from '%s'%s\n",
+               s_schema.size(), path.c_str(), errors ? " (with errors)" : "");
+    return errors == 0;
+}
 
-    // Graphics — MSAA (vid_fsaa: 0, 2, 4, 8)
-    {
-        std::vector<int> values = {0, 2, 4, 8};
-        const char* labels[] = {"Off", "2x", "4x", "8x"};
-        RegisterEnumValues("vid_fsaa", "msaa", values, labels);
+std::vector<std::string> CvarBindingManager::TokenizeSchemaLine(const std::string& source,
+                                                                size_t begin, size_t end)
+{
+    // Whitespace-separated; double quotes group spaces into a token, # starts a comment
+    std::vector<std::string> tokens;
+    std::string token;
+    bool in_token = false;
+    bool quoted = false;
+
+    for (size_t i = begin; i < end; ++i) {
+        char c = source[i];
+        if (c == '"') {
+            quoted = !quoted;
+            in_token = true;
+        } else if (!quoted && c == '#') {
+            break;
+        } else if (!quoted && std::isspace(static_cast<unsigned char>(c))) {
+            if (in_token) {
+                tokens.push_back(std::move(token));
+                token.clear();
+                in_token = false;
+            }
+        } else {
+            token += c;
+            in_token = true;
+        }
     }
-
-    // Graphics — AA mode (vid_fsaamode: 0=Off, 1=FXAA, 2=TAA)
-    {
-        const char* labels[] = {"Off", "FXAA", "TAA"};
-        RegisterEnum("vid_fsaamode", "aa_mode", 3, labels);
+    if (in_token) {
+        tokens.push_back(std::move(token));
     }
+    return tokens;
+}
 
-    // Graphics — render scale (r_scale: 1=Native, 2=2x, 4=4x)
-    {
-        std::vector<int> values = {1, 2, 4};
-        const char* labels[] = {"Native", "2x", "4x"};
-        RegisterEnumValues("r_scale", "render_scale", values, labels);
+bool CvarBindingManager::ParseSchemaEntry(const std::vector<std::string>& line, CvarBinding& binding)
+{
+    // A leading "restart" marks settings that only take effect after vid_restart
+    binding.requires_restart = !line.empty() && line[0] == "restart";
+    std::vector<std::string> tokens(line.begin() + (binding.requires_restart ? 1 : 0), line.end());
+    if (tokens.size() < 3) return false;
+
+    auto parse_float = [](const std::string& text, float& value) {
+        char* end = nullptr;
+        value = std::strtof(text.c_str(), &end);
+        return end != text.c_str() && *end == '\0';
+    };
+    auto parse_int = [](const std::string& text, int& value) {
+        char* end = nullptr;
+        value = static_cast<int>(std::strtol(text.c_str(), &end, 10));
+        return end != text.c_str() && *end == '\0';
+    };
+
+    const std::string& type = tokens[0];
+    binding.cvar_name = tokens[1];
+    binding.ui_name = tokens[2];
+
+    if (type == "float") {
+        binding.type = CvarType::Float;
+        return tokens.size() == 6 &&
+               parse_float(tokens[3], binding.min_value) &&
+               parse_float(tokens[4], binding.max_value) &&
+               parse_float(tokens[5], binding.step);
     }
 
-    // Graphics — particles (r_particles: 0=Off, 1=Classic, 2=Enhanced)
-    {
-        const char* labels[] = {"Off", "Classic", "Enhanced"};
-        RegisterEnum("r_particles", "particles", 3, labels);
+    if (type == "int") {
+        int min = 0, max = 0;
+        binding.type = CvarType::Int;
+        if (tokens.size() != 5 || !parse_int(tokens[3], min) || !parse_int(tokens[4], max)) {
+            return false;
+        }
+        binding.min_value = static_cast<float>(min);
+        binding.max_value = static_cast<float>(max);
+        return true;
     }
 
-    // Graphics — enhanced models (r_enhancedmodels)
-    {
-        const char* labels[] = {"Off", "On"};
-        RegisterEnum("r_enhancedmodels", "enhanced_models", 2, labels);
+    if (type == "bool" || type == "string") {
+        binding.type = type == "bool" ? CvarType::Bool : CvarType::String;
+        return tokens.size() == 3;
     }
 
-    // Sound — quality (snd_mixspeed: common rates)
-    {
-        std::vector<int> values = {11025, 22050, 44100, 48000};
-        const char* labels[] = {"11 kHz", "22 kHz", "44 kHz", "48 kHz"};
-        RegisterEnumValues("snd_mixspeed", "sound_quality", values, labels);
-    }
+    if (type == "enum") {
+        binding.type = CvarType::Enum;
+        if (tokens.size() < 4) return false;
 
-    // Sound — ambient (ambient_level mapped to off/low/medium/high)
-    {
-        const char* labels[] = {"Off", "On"};
-        RegisterEnum("ambient_level", "ambient", 2, labels);
-    }
+        for (size_t i = 3; i < tokens.size(); ++i) {
+            size_t equals = tokens[i].find('=');
+            int value = static_cast<int>(i - 3);
+            if (equals != std::string::npos && !parse_int(tokens[i].substr(0, equals), value)) {
+                return false;
+            }
+            binding.enum_values.push_back(value);
+            binding.enum_labels.push_back(equals != std::string::npos
+                                              ? tokens[i].substr(equals + 1)
+                                              : tokens[i]);
+        }
 
-    // Game — crosshair (crosshair: 0=Off, 1=Cross, 2=Dot)
-    {
-        const char* labels[] = {"Off", "Cross", "Dot"};
-        RegisterEnum("crosshair", "crosshair", 3, labels);
+        binding.num_values = static_cast<int>(binding.enum_values.size());
+        auto minmax = std::minmax_element(binding.enum_values.begin(), binding.enum_values.end());
+        binding.min_value = static_cast<float>(*minmax.first);
+        binding.max_value = static_cast<float>(*minmax.second);
+        return true;
     }
 
-    // Game — show FPS (scr_showfps: 0=Off, 1=On)
-    {
-        const char* labels[] = {"Off", "On"};
-        RegisterEnum("scr_showfps", "show_fps", 2, labels);
-    }
+    return false;
+}
 
-    // Game — aim assist (sv_aim: 0=Off, 1=On)
-    {
-        const char* labels[] = {"Off", "On"};
-        RegisterEnum("sv_aim", "sv_aim", 2, labels);
-    }
+void CvarBindingManager::AttachReferenced(const std::string& document_path)
+{
+    if (!s_initialized) return;
 
-    // Game — gun kick (v_gunkick: 0=Off, 1=Classic, 2=Smooth)
-    {
-        const char* labels[] = {"Off", "Classic", "Smooth"};
-        RegisterEnum("v_gunkick", "gun_kick", 3, labels);
-    }
+    Rml::FileInterface* file_interface = Rml::GetFileInterface();
+    Rml::FileHandle file = file_interface ? file_interface->Open(document_path) : 0;
+    if (!file) return;
+
+    std::string source(file_interface->Length(file), '\0');
+    source.resize(file_interface->Read(&source[0], source.size(), file));
+    file_interface->Close(file);
+
+    // Every identifier in the document is a candidate: data-value, data-if,
+    // {{ name_label }} and cycle_cvar('name') all spell the UI name out
+    size_t attached = 0;
+    size_t i = 0;
+    while (i < source.size()) {
+        unsigned char c = static_cast<unsigned char>(source[i]);
+        if (!std::isalpha(c) && c != '_') {
+            i++;
+            continue;
+        }
 
-    // Game — auto fast load (autofastload: 0=Off, 1=On)
-    {
-        const char* labels[] = {"Off", "On"};
-        RegisterEnum("autofastload", "auto_load", 2, labels);
-    }
+        size_t start = i;
+        while (i < source.size() &&
+               (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_')) {
+            i++;
+        }
 
-    // Game — HUD style (scr_style: 0=Simple, 1=Classic, 2=Modern)
-    {
-        const char* labels[] = {"Simple", "Classic", "Modern"};
-        RegisterEnum("scr_style", "hud_style", 3, labels);
+        std::string name = source.substr(start, i - start);
+        if (AttachFromSchema(name)) {
+            attached++;
+        } else if (name.size() > 6 && name.compare(name.size() - 6, 6, "_label") == 0 &&
+                   AttachFromSchema(name.substr(0, name.size() - 6))) {
+            attached++;
+        }
     }
 
-    // Game — skill level (skill: 0=Easy, 1=Normal, 2=Hard, 3=Nightmare)
-    {
-        const char* labels[] = {"Easy", "Normal", "Hard", "Nightmare"};
-        RegisterEnum("skill", "skill", 4, labels);
+    if (attached > 0) {
+        Con_Printf("CvarBindingManager: Attached %zu bindings for '%s'\n",
+                   attached, document_path.c_str());
     }
+}
 
-    // Player setup — colors (_cl_color is a packed int, top = val/16, bottom = val%16)
-    {
-        std::vector<int> values = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
-        const char* labels[] = {"White", "Brown", "Blue", "Green", "Red", "Gold",
-                                "Peach", "Purple", "Magenta", "Tan", "Grey",
-                                "Orange", "Yellow", "Olive"};
-        RegisterEnumValues("_cl_color", "cl_color_top", values, labels);
-        RegisterEnumValues("_cl_color", "cl_color_bottom", values, labels);
-    }
+bool CvarBindingManager::AttachFromSchema(const std::string& ui_name)
+{
+    if (!s_initialized || s_bindings.count(ui_name)) return false;
+
+    auto it = s_schema.find(ui_name);
+    if (it == s_schema.end()) return false;
+
+    Attach(it->second);
+    return true;
 }
 
 void CvarBindingManager::Shutdown()
 {
     if (!s_initialized) return;
 
+    s_schema.clear();
     s_bindings.clear();
     s_float_values.clear();
     s_int_values.clear();
     s_string_values.clear();
+    s_sync_entries.clear();
+    s_entry_index.clear();
+    s_entries_by_cvar.clear();
+    s_pending.clear();
+    s_staged.clear();
     s_model_handle = Rml::DataModelHandle();
     s_context = nullptr;
     s_initialized = false;
@@ -270,6 +331,67 @@ void CvarBindingManager::Shutdown()
     Con_Printf("CvarBindingManager: Shutdown\n");
 }
 
+namespace {
+
+// Stores the backing value for a binding and binds it to the "cvars" model
+// the first time; a re-registered UI name keeps its pointer and just updates
+template <typename T>
+void BindValue(Rml::Context* context, std::unordered_map<std::string, std::unique_ptr<T>>& values,
+               const std::string& ui_name, T value)
+{
+    auto it = values.find(ui_name);
+    if (it != values.end()) {
+        if (it->second) *(it->second) = std::move(value);
+        return;
+    }
+
+    auto value_ptr = std::make_unique<T>(std::move(value));
+    T* raw_ptr = value_ptr.get();
+    values[ui_name] = std::move(value_ptr);
+
+    if (context) {
+        Rml::DataModelConstructor constructor = context->GetDataModel("cvars");
+        if (constructor && !constructor.Bind(ui_name, raw_ptr)) {
+            Con_Printf("CvarBindingManager: ERROR - Failed to bind '%s'\n", ui_name.c_str());
+        }
+    }
+}
+
+} // namespace
+
+void CvarBindingManager::Attach(const CvarBinding& binding)
+{
+    const std::string& ui_name = binding.ui_name;
+    const char* cvar = binding.cvar_name.c_str();
+    bool new_label = binding.type == CvarType::Enum && !binding.enum_labels.empty() &&
+                     !s_int_values.count(ui_name);
+
+    s_bindings[ui_name] = binding;
+
+    // Initialize with current cvar value
+    switch (binding.type) {
+        case CvarType::Float:
+            BindValue(s_context, s_float_values, ui_name, GetProvider()->GetFloat(cvar));
+            break;
+        case CvarType::Bool:
+        case CvarType::Int:
+        case CvarType::Enum:
+            BindValue(s_context, s_int_values, ui_name,
+                      IsInvertMouseBinding(ui_name) ? GetInvertMouseValue(GetProvider())
+                                                    : static_cast<int>(GetProvider()->GetFloat(cvar)));
+            break;
+        case CvarType::String:
+            BindValue(s_context, s_string_values, ui_name, Rml::String(GetProvider()->GetString(cvar)));
+            break;
+    }
+
+    if (new_label) {
+        BindEnumLabel(ui_name.c_str());
+    }
+
+    AddSyncEntry(binding);
+}
+
 void CvarBindingManager::RegisterFloat(const char* cvar, const char* ui_name,
                                         float min, float max, float step)
 {
@@ -283,28 +405,7 @@ void CvarBindingManager::RegisterFloat(const char* cvar, const char* ui_name,
     binding.max_value = max;
     binding.step = step;
 
-    s_bindings[ui_name] = binding;
-
-    // Initialize with current cvar value
-    float value = GetProvider()->GetFloat(cvar);
-    auto it = s_float_values.find(ui_name);
-    if (it == s_float_values.end()) {
-        auto value_ptr = std::make_unique<float>(value);
-        float* raw_ptr = value_ptr.get();
-        s_float_values[ui_name] = std::move(value_ptr);
-
-        if (s_context) {
-            Rml::DataModelConstructor constructor = s_context->GetDataModel("cvars");
-            if (constructor && !constructor.Bind(ui_name, raw_ptr)) {
-                Con_Printf("CvarBindingManager: ERROR - Failed to bind float '%s'\n", ui_name);
-            }
-        }
-    } else if (it->second) {
-        *(it->second) = value;
-    }
-
-    Con_Printf("CvarBindingManager: Registered float '%s' -> '%s' (%.2f-%.2f)\n",
-               cvar, ui_name, min, max);
+    Attach(binding);
 }
 
 void CvarBindingManager::RegisterBool(const char* cvar, const char* ui_name)
@@ -316,29 +417,7 @@ void CvarBindingManager::RegisterBool(const char* cvar, const char* ui_name)
     binding.ui_name = ui_name;
     binding.type = CvarType::Bool;
 
-    s_bindings[ui_name] = binding;
-
-    // Initialize with current cvar value
-    int value = IsInvertMouseBinding(ui_name)
-        ? GetInvertMouseValue(GetProvider())
-        : static_cast<int>(GetProvider()->GetFloat(cvar));
-    auto it = s_int_values.find(ui_name);
-    if (it == s_int_values.end()) {
-        auto value_ptr = std::make_unique<int>(value);
-        int* raw_ptr = value_ptr.get();
-        s_int_values[ui_name] = std::move(value_ptr);
-
-        if (s_context) {
-            Rml::DataModelConstructor constructor = s_context->GetDataModel("cvars");
-            if (constructor && !constructor.Bind(ui_name, raw_ptr)) {
-                Con_Printf("CvarBindingManager: ERROR - Failed to bind bool '%s'\n", ui_name);
-            }
-        }
-    } else if (it->second) {
-        *(it->second) = value;
-    }
-
-    Con_Printf("CvarBindingManager: Registered bool '%s' -> '%s'\n", cvar, ui_name);
+    Attach(binding);
 }
 
 void CvarBindingManager::RegisterInt(const char* cvar, const char* ui_name,
@@ -353,28 +432,7 @@ void CvarBindingManager::RegisterInt(const char* cvar, const char* ui_name,
     binding.min_value = static_cast<float>(min);
     binding.max_value = static_cast<float>(max);
 
-    s_bindings[ui_name] = binding;
-
-    // Initialize with current cvar value
-    int value = static_cast<int>(GetProvider()->GetFloat(cvar));
-    auto it = s_int_values.find(ui_name);
-    if (it == s_int_values.end()) {
-        auto value_ptr = std::make_unique<int>(value);
-        int* raw_ptr = value_ptr.get();
-        s_int_values[ui_name] = std::move(value_ptr);
-
-        if (s_context) {
-            Rml::DataModelConstructor constructor = s_context->GetDataModel("cvars");
-            if (constructor && !constructor.Bind(ui_name, raw_ptr)) {
-                Con_Printf("CvarBindingManager: ERROR - Failed to bind int '%s'\n", ui_name);
-            }
-        }
-    } else if (it->second) {
-        *(it->second) = value;
-    }
-
-    Con_Printf("CvarBindingManager: Registered int '%s' -> '%s' (%d-%d)\n",
-               cvar, ui_name, min, max);
+    Attach(binding);
 }
 
 void CvarBindingManager::BindEnumLabel(const char* ui_name)
@@ -429,30 +487,7 @@ void CvarBindingManager::RegisterEnum(const char* cvar, const char* ui_name,
         }
     }
 
-    s_bindings[ui_name] = binding;
-
-    // Initialize with current cvar value
-    int value = static_cast<int>(GetProvider()->GetFloat(cvar));
-    auto it = s_int_values.find(ui_name);
-    if (it == s_int_values.end()) {
-        auto value_ptr = std::make_unique<int>(value);
-        int* raw_ptr = value_ptr.get();
-        s_int_values[ui_name] = std::move(value_ptr);
-
-        if (s_context) {
-            Rml::DataModelConstructor constructor = s_context->GetDataModel("cvars");
-            if (constructor && !constructor.Bind(ui_name, raw_ptr)) {
-                Con_Printf("CvarBindingManager: ERROR - Failed to bind enum '%s'\n", ui_name);
-            }
-        }
-    } else if (it->second) {
-        *(it->second) = value;
-    }
-
-    BindEnumLabel(ui_name);
-
-    Con_Printf("CvarBindingManager: Registered enum '%s' -> '%s' (%d values)\n",
-               cvar, ui_name, num_values);
+    Attach(binding);
 }
 
 void CvarBindingManager::RegisterEnumValues(const char* cvar, const char* ui_name,
@@ -481,29 +516,7 @@ void CvarBindingManager::RegisterEnumValues(const char* cvar, const char* ui_nam
         }
     }
 
-    s_bindings[ui_name] = binding;
-
-    int value = static_cast<int>(GetProvider()->GetFloat(cvar));
-    auto it = s_int_values.find(ui_name);
-    if (it == s_int_values.end()) {
-        auto value_ptr = std::make_unique<int>(value);
-        int* raw_ptr = value_ptr.get();
-        s_int_values[ui_name] = std::move(value_ptr);
-
-        if (s_context) {
-            Rml::DataModelConstructor constructor = s_context->GetDataModel("cvars");
-            if (constructor && !constructor.Bind(ui_name, raw_ptr)) {
-                Con_Printf("CvarBindingManager: ERROR - Failed to bind enum '%s'\n", ui_name);
-            }
-        }
-    } else if (it->second) {
-        *(it->second) = value;
-    }
-
-    BindEnumLabel(ui_name);
-
-    Con_Printf("CvarBindingManager: Registered enum values '%s' -> '%s' (%d values)\n",
-               cvar, ui_name, binding.num_values);
+    Attach(binding);
 }
 
 void CvarBindingManager::RegisterString(const char* cvar, const char* ui_name)
@@ -515,33 +528,121 @@ void CvarBindingManager::RegisterString(const char* cvar, const char* ui_name)
     binding.ui_name = ui_name;
     binding.type = CvarType::String;
 
-    s_bindings[ui_name] = binding;
+    Attach(binding);
+}
 
-    // Initialize with current cvar value
-    Rml::String value = GetProvider()->GetString(cvar);
-    auto it = s_string_values.find(ui_name);
-    if (it == s_string_values.end()) {
-        auto value_ptr = std::make_unique<Rml::String>(value);
-        Rml::String* raw_ptr = value_ptr.get();
-        s_string_values[ui_name] = std::move(value_ptr);
-
-        if (s_context) {
-            Rml::DataModelConstructor constructor = s_context->GetDataModel("cvars");
-            if (constructor && !constructor.Bind(ui_name, raw_ptr)) {
-                Con_Printf("CvarBindingManager: ERROR - Failed to bind string '%s'\n", ui_name);
-            }
+void CvarBindingManager::SyncToUI()
+{
+    if (!s_initialized) return;
+
+    size_t changed = 0;
+    for (const SyncEntry& entry : s_sync_entries) {
+        // Unwritten edits keep showing what the user picked
+        if (entry.pending || entry.staged) continue;
+
+        if (RefreshEntry(entry)) {
+            DirtyEntry(entry);
+            changed++;
         }
-    } else if (it->second) {
-        *(it->second) = value;
     }
 
-    Con_Printf("CvarBindingManager: Registered string '%s' -> '%s'\n", cvar, ui_name);
+    if (changed > 0) {
+        SuppressUIChanges();
+    }
+    Con_Printf("CvarBindingManager: Synced %zu cvars to UI (%zu changed)\n",
+               s_sync_entries.size(), changed);
 }
 
-void CvarBindingManager::SyncToUI()
+void CvarBindingManager::OnCvarChanged(const char* cvar_name)
 {
-    if (!s_initialized) return;
+    s_change_notifications = true;
+    if (!s_initialized || !cvar_name) return;
+
+    auto it = s_entries_by_cvar.find(cvar_name);
+    if (it == s_entries_by_cvar.end()) return;
+
+    bool changed = false;
+    for (size_t index : it->second) {
+        const SyncEntry& entry = s_sync_entries[index];
+
+        // The binding being written already holds the value; re-reading it
+        // could round a slider mid-drag
+        if (s_writing_ui_name && *s_writing_ui_name == entry.ui_name) continue;
+        if (entry.pending || entry.staged) continue;
+
+        if (RefreshEntry(entry)) {
+            DirtyEntry(entry);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        SuppressUIChanges();
+    }
+}
+
+bool CvarBindingManager::HasChangeNotifications()
+{
+    return s_change_notifications;
+}
 
+bool CvarBindingManager::RefreshEntry(const SyncEntry& entry)
+{
+    switch (entry.type) {
+        case CvarType::Float:
+            if (entry.float_value) {
+                float value = entry.cvar.GetFloat();
+                if (*entry.float_value != value) {
+                    *entry.float_value = value;
+                    return true;
+                }
+            }
+            break;
+        case CvarType::Bool:
+        case CvarType::Int:
+        case CvarType::Enum:
+            if (entry.int_value) {
+                float raw = entry.cvar.GetFloat();
+                int value = entry.invert_mouse ? (raw < 0.0f ? 1 : 0) : static_cast<int>(raw);
+                if (*entry.int_value != value) {
+                    *entry.int_value = value;
+                    return true;
+                }
+            }
+            break;
+        case CvarType::String:
+            if (entry.string_value) {
+                const char* value = entry.cvar.GetString();
+                if (*entry.string_value != value) {
+                    *entry.string_value = value;
+                    return true;
+                }
+            }
+            break;
+    }
+    return false;
+}
+
+void CvarBindingManager::DirtyEntry(const SyncEntry& entry)
+{
+    if (!s_model_handle) return;
+
+    s_model_handle.DirtyVariable(entry.ui_name);
+    if (entry.has_label) {
+        s_model_handle.DirtyVariable(entry.ui_name + "_label");
+    }
+}
+
+void CvarBindingManager::DirtyBinding(const std::string& ui_name)
+{
+    auto it = s_entry_index.find(ui_name);
+    if (it != s_entry_index.end()) {
+        DirtyEntry(s_sync_entries[it->second]);
+    }
+}
+
+void CvarBindingManager::SuppressUIChanges()
+{
     // Suppress UI change handling for the next two update ticks. Data binding
     // updates emit "change" events when dirty values are pushed to elements.
     // SyncToUI is often called from within g_context->Update() (via event
@@ -549,39 +650,47 @@ void CvarBindingManager::SyncToUI()
     // Update() call — requiring two frames of suppression.
     s_ignore_ui_changes = true;
     s_ignore_ui_changes_frames = 2;
+}
 
-    for (auto& pair : s_bindings) {
-        const CvarBinding& binding = pair.second;
-        const char* cvar_name = binding.cvar_name.c_str();
+void CvarBindingManager::AddSyncEntry(const CvarBinding& binding)
+{
+    SyncEntry entry{binding.ui_name, CvarHandle(binding.cvar_name), binding.type,
+                    IsInvertMouseBinding(binding.ui_name), !binding.enum_labels.empty(),
+                    binding.requires_restart, false, false, nullptr, nullptr, nullptr};
 
-        switch (binding.type) {
-            case CvarType::Float:
-                if (auto it = s_float_values.find(binding.ui_name); it != s_float_values.end() && it->second) {
-                    *(it->second) = GetProvider()->GetFloat(cvar_name);
-                }
-                break;
-            case CvarType::Bool:
-            case CvarType::Int:
-            case CvarType::Enum:
-                if (auto it = s_int_values.find(binding.ui_name); it != s_int_values.end() && it->second) {
-                    if (IsInvertMouseBinding(binding.ui_name)) {
-                        *(it->second) = GetInvertMouseValue(GetProvider());
-                    } else {
-                        *(it->second) = static_cast<int>(GetProvider()->GetFloat(cvar_name));
-                    }
-                }
-                break;
-            case CvarType::String: {
-                if (auto it = s_string_values.find(binding.ui_name); it != s_string_values.end() && it->second) {
-                    *(it->second) = GetProvider()->GetString(cvar_name);
-                }
-                break;
+    switch (binding.type) {
+        case CvarType::Float:
+            if (auto it = s_float_values.find(binding.ui_name); it != s_float_values.end()) {
+                entry.float_value = it->second.get();
             }
-        }
+            break;
+        case CvarType::Bool:
+        case CvarType::Int:
+        case CvarType::Enum:
+            if (auto it = s_int_values.find(binding.ui_name); it != s_int_values.end()) {
+                entry.int_value = it->second.get();
+            }
+            break;
+        case CvarType::String:
+            if (auto it = s_string_values.find(binding.ui_name); it != s_string_values.end()) {
+                entry.string_value = it->second.get();
+            }
+            break;
     }
 
-    MarkDirty();
-    Con_Printf("CvarBindingManager: Synced %zu cvars to UI\n", s_bindings.size());
+    // Re-registering a UI name replaces its entry
+    auto it = s_entry_index.find(binding.ui_name);
+    size_t index = it != s_entry_index.end() ? it->second : s_sync_entries.size();
+    if (it != s_entry_index.end()) {
+        SetStaged(index, false);
+        std::vector<size_t>& previous = s_entries_by_cvar[s_sync_entries[index].cvar.GetName()];
+        previous.erase(std::remove(previous.begin(), previous.end(), index), previous.end());
+        s_sync_entries[index] = std::move(entry);
+    } else {
+        s_sync_entries.push_back(std::move(entry));
+        s_entry_index[binding.ui_name] = index;
+    }
+    s_entries_by_cvar[binding.cvar_name].push_back(index);
 }
 
 bool CvarBindingManager::ShouldIgnoreUIChange()
@@ -603,44 +712,131 @@ void CvarBindingManager::SyncFromUI(const std::string& ui_name)
 {
     if (!s_initialized) return;
 
-    auto it = s_bindings.find(ui_name);
-    if (it == s_bindings.end()) {
+    auto it = s_entry_index.find(ui_name);
+    if (it == s_entry_index.end()) {
         Con_Printf("CvarBindingManager: Unknown UI binding '%s'\n", ui_name.c_str());
         return;
     }
 
-    const CvarBinding& binding = it->second;
-    const char* cvar_name = binding.cvar_name.c_str();
+    size_t index = it->second;
+    SyncEntry& entry = s_sync_entries[index];
+    if (entry.requires_restart) {
+        SetStaged(index, true);
+    } else if (!entry.pending) {
+        entry.pending = true;
+        s_pending.push_back(index);
+    }
+}
 
-    switch (binding.type) {
-        case CvarType::Float: {
-            auto val_it = s_float_values.find(ui_name);
-            if (val_it != s_float_values.end() && val_it->second) {
-                GetProvider()->SetFloat(cvar_name, *(val_it->second));
+void CvarBindingManager::FlushPending()
+{
+    if (s_pending.empty()) return;
+
+    for (size_t index : s_pending) {
+        SyncEntry& entry = s_sync_entries[index];
+        if (!entry.pending) continue;
+
+        entry.pending = false;
+        WriteEntry(entry);
+    }
+    s_pending.clear();
+}
+
+bool CvarBindingManager::ApplyStaged()
+{
+    if (s_staged.empty()) return false;
+
+    size_t count = 0;
+    for (size_t index : s_staged) {
+        SyncEntry& entry = s_sync_entries[index];
+        if (!entry.staged) continue;
+
+        entry.staged = false;
+        WriteEntry(entry);
+        count++;
+    }
+    s_staged.clear();
+    if (s_model_handle) {
+        s_model_handle.DirtyVariable("settings_pending");
+    }
+
+    Con_Printf("CvarBindingManager: Applied %zu staged settings\n", count);
+    return count > 0;
+}
+
+void CvarBindingManager::RevertStaged()
+{
+    if (s_staged.empty()) return;
+
+    for (size_t index : s_staged) {
+        SyncEntry& entry = s_sync_entries[index];
+        if (!entry.staged) continue;
+
+        entry.staged = false;
+        if (RefreshEntry(entry)) {
+            DirtyEntry(entry);
+        }
+    }
+    s_staged.clear();
+    SuppressUIChanges();
+    if (s_model_handle) {
+        s_model_handle.DirtyVariable("settings_pending");
+    }
+}
+
+bool CvarBindingManager::HasStagedChanges()
+{
+    return !s_staged.empty();
+}
+
+void CvarBindingManager::SetStaged(size_t index, bool staged)
+{
+    SyncEntry& entry = s_sync_entries[index];
+    if (entry.staged == staged) return;
+
+    bool was_empty = s_staged.empty();
+    entry.staged = staged;
+    if (staged) {
+        s_staged.push_back(index);
+    } else {
+        s_staged.erase(std::remove(s_staged.begin(), s_staged.end(), index), s_staged.end());
+    }
+
+    if (was_empty != s_staged.empty() && s_model_handle) {
+        s_model_handle.DirtyVariable("settings_pending");
+    }
+}
+
+void CvarBindingManager::WriteEntry(const SyncEntry& entry)
+{
+    const char* cvar_name = entry.cvar.GetName().c_str();
+    s_writing_ui_name = &entry.ui_name;
+
+    switch (entry.type) {
+        case CvarType::Float:
+            if (entry.float_value) {
+                GetProvider()->SetFloat(cvar_name, *entry.float_value);
             }
             break;
-        }
         case CvarType::Bool:
         case CvarType::Int:
-        case CvarType::Enum: {
-            auto val_it = s_int_values.find(ui_name);
-            if (val_it != s_int_values.end() && val_it->second) {
-                if (IsInvertMouseBinding(binding.ui_name)) {
-                    SetInvertMouseValue(GetProvider(), *(val_it->second) != 0);
+        case CvarType::Enum:
+            if (entry.int_value) {
+                if (entry.invert_mouse) {
+                    SetInvertMouseValue(GetProvider(), *entry.int_value != 0);
                 } else {
-                    GetProvider()->SetFloat(cvar_name, static_cast<float>(*(val_it->second)));
+                    GetProvider()->SetFloat(cvar_name, static_cast<float>(*entry.int_value));
                 }
             }
             break;
-        }
-        case CvarType::String: {
-            auto val_it = s_string_values.find(ui_name);
-            if (val_it != s_string_values.end() && val_it->second) {
-                GetProvider()->SetString(cvar_name, val_it->second->c_str());
+        case CvarType::String:
+            if (entry.string_value) {
+                GetProvider()->SetString(cvar_name, *entry.string_value);
             }
             break;
-        }
     }
+
+    s_writing_ui_name = nullptr;
 }
 
 void CvarBindingManager::SyncAllFromUI()
@@ -655,6 +851,9 @@ void CvarBindingManager::SyncAllFromUI()
 const CvarBinding* CvarBindingManager::GetBinding(const std::string& ui_name)
 {
     auto it = s_bindings.find(ui_name);
+    if (it == s_bindings.end() && AttachFromSchema(ui_name)) {
+        it = s_bindings.find(ui_name);
+    }
     if (it != s_bindings.end()) {
         return &it->second;
     }
@@ -695,7 +894,7 @@ void CvarBindingManager::SetFloatValue(const std::string& ui_name, float value)
         *(it->second) = value;
     }
     SyncFromUI(ui_name);
-    MarkDirty();
+    DirtyBinding(ui_name);
 }
 
 bool CvarBindingManager::GetBoolValue(const std::string& ui_name)
@@ -714,7 +913,7 @@ void CvarBindingManager::SetBoolValue(const std::string& ui_name, bool value)
         *(it->second) = value ? 1 : 0;
     }
     SyncFromUI(ui_name);
-    MarkDirty();
+    DirtyBinding(ui_name);
 }
 
 int CvarBindingManager::GetIntValue(const std::string& ui_name)
@@ -741,7 +940,7 @@ void CvarBindingManager::SetIntValue(const std::string& ui_name, int value)
         *(it->second) = value;
     }
     SyncFromUI(ui_name);
-    MarkDirty();
+    DirtyBinding(ui_name);
 }
 
 Rml::String CvarBindingManager::GetStringValue(const std::string& ui_name)
@@ -760,7 +959,7 @@ void CvarBindingManager::SetStringValue(const std::string& ui_name, const Rml::S
         *(it->second) = value;
     }
     SyncFromUI(ui_name);
-    MarkDirty();
+    DirtyBinding(ui_name);
 }
 
 void CvarBindingManager::CycleEnum(const std::string& ui_name, int delta)
@@ -5,6 +5,9 @@
  * Cvars are registered with a UI name and automatically synced when menus open
  * or when UI values change.
  *
+ * Bindings are declared in ui/cvar_bindings.txt. Each one is attached to the
+ * data model when a document that mentions its UI name is about to load.
+ *
  * Usage in RML:
  *   <body data-model="cvars">
  *     <input type="range" min="1" max="11" step="0.5"
@@ -23,6 +26,7 @@
 #include <vector>
 #include "../types/cvar_provider.h"
 #include "../types/cvar_schema.h"
+#include "cvar_handle.h"
 
 namespace Tatoosh {
 
@@ -40,6 +44,15 @@ public:
     // Shutdown and cleanup
     static void Shutdown();
 
+    // Parse the binding schema (ui/cvar_bindings.txt). Nothing is bound yet.
+    static bool LoadSchema(const std::string& path);
+
+    // Attach the schema bindings a document mentions. Call before loading it.
+    static void AttachReferenced(const std::string& document_path);
+
+    // Attach one schema binding by UI name; false if unknown or already attached
+    static bool AttachFromSchema(const std::string& ui_name);
+
     // Register a float cvar with optional range and step
     static void RegisterFloat(const char* cvar, const char* ui_name,
                               float min = 0.0f, float max = 1.0f, float step = 0.1f);
@@ -63,19 +76,46 @@ public:
     // Register a string cvar
     static void RegisterString(const char* cvar, const char* ui_name);
 
-    // Sync all cvar values to UI (call when opening menu)
+    // Re-read every bound cvar and dirty the ones that changed. Not needed on
+    // menu open once the engine reports changes through OnCvarChanged.
     static void SyncToUI();
 
-    // Sync a specific UI value back to its cvar (call on UI change event)
+    // Engine notification that a cvar was set. Refreshes the bindings backed
+    // by it and dirties only those variables.
+    static void OnCvarChanged(const char* cvar_name);
+
+    // True once the engine has reported a cvar change, i.e. backing values
+    // track the engine without SyncToUI
+    static bool HasChangeNotifications();
+
+    // Queue a UI value to be written back to its cvar (call on UI change
+    // event). Written by the next FlushPending, or staged if the binding
+    // requires a video restart.
     static void SyncFromUI(const std::string& ui_name);
 
+    // Write the values queued since the last call, each binding once however
+    // many change events a dragged slider sent. Call once per frame.
+    static void FlushPending();
+
+    // Write the staged restart-requiring values together. Returns true if a
+    // vid_restart is needed for them to take effect.
+    static bool ApplyStaged();
+
+    // Drop the staged values and show the cvars' current values again
+    static void RevertStaged();
+
+    // True while restart-requiring edits wait for ApplyStaged
+    static bool HasStagedChanges();
+
     // Sync all UI values back to cvars
     static void SyncAllFromUI();
 
-    // Get binding info for a UI name (nullptr if not found)
+    // Get binding info for a UI name, attaching it from the schema if needed
+    // (nullptr if not found)
     static const CvarBinding* GetBinding(const std::string& ui_name);
 
-    // Mark the data model as dirty (triggers UI update)
+    // Mark every variable of the data model dirty (full refresh). The
+    // setters below dirty only the binding they change.
     static void MarkDirty();
 
     // Suppress UI-originated change events during sync to avoid feedback loops.
@@ -115,15 +155,49 @@ public:
     static void CycleEnum(const std::string& ui_name, int delta = 1);
 
 private:
-    static void RegisterAllBindings();
+    // What SyncToUI needs per binding, resolved at registration so the sync
+    // does no map or cvar lookups
+    struct SyncEntry {
+        std::string ui_name;
+        CvarHandle cvar;
+        CvarType type;
+        bool invert_mouse;
+        bool has_label;          // Also dirty "<ui_name>_label"
+        bool requires_restart;
+        bool pending;            // Queued for FlushPending
+        bool staged;             // Waiting for ApplyStaged
+        float* float_value;
+        int* int_value;
+        Rml::String* string_value;
+    };
+
+    static std::vector<std::string> TokenizeSchemaLine(const std::string& source,
+                                                       size_t begin, size_t end);
+    static bool ParseSchemaEntry(const std::vector<std::string>& tokens, CvarBinding& binding);
+    static void Attach(const CvarBinding& binding);
     static void BindEnumLabel(const char* ui_name);
+    static void AddSyncEntry(const CvarBinding& binding);
+    static bool RefreshEntry(const SyncEntry& entry);
+    static void WriteEntry(const SyncEntry& entry);
+    static void SetStaged(size_t index, bool staged);
+    static void DirtyEntry(const SyncEntry& entry);
+    static void DirtyBinding(const std::string& ui_name);
+    static void SuppressUIChanges();
 
     static Rml::Context* s_context;
     static Rml::DataModelHandle s_model_handle;
-    static std::unordered_map<std::string, CvarBinding> s_bindings;
+    static std::unordered_map<std::string, CvarBinding> s_schema;     // Declared, by UI name
+    static std::unordered_map<std::string, CvarBinding> s_bindings;   // Attached
     static std::unordered_map<std::string, std::unique_ptr<float>> s_float_values;
     static std::unordered_map<std::string, std::unique_ptr<int>> s_int_values;
     static std::unordered_map<std::string, std::unique_ptr<Rml::String>> s_string_values;
+    static std::vector<SyncEntry> s_sync_entries;
+    static std::unordered_map<std::string, size_t> s_entry_index;      // By UI name
+    static std::unordered_map<std::string, std::vector<size_t>> s_entries_by_cvar;
+    static std::vector<size_t> s_pending;
+    static std::vector<size_t> s_staged;
+    static bool s_change_notifications;
+    static const std::string* s_writing_ui_name;   // Binding SyncFromUI is writing back
     static bool s_initialized;
     static ICvarProvider* s_provider;  // Injected cvar provider
     static bool s_ignore_ui_changes;
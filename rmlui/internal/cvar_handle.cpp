@@ -0,0 +1,56 @@
+/*
+ * Tatoosh - Cvar Handle Implementation
+ */
+
+#include "cvar_handle.h"
+#include "cvar_binding.h"
+
+#include <utility>
+
+namespace Tatoosh {
+
+// Starts at 1 so a new handle (generation 0) resolves on first use
+uint32_t CvarHandle::s_generation = 1;
+
+CvarHandle::CvarHandle(std::string name)
+    : m_name(std::move(name))
+    , m_provider(nullptr)
+    , m_ref()
+    , m_generation(0)
+{
+}
+
+void CvarHandle::InvalidateAll()
+{
+    s_generation++;
+}
+
+ICvarProvider* CvarHandle::Resolve() const
+{
+    ICvarProvider* provider = CvarBindingManager::GetProvider();
+    if (provider != m_provider || m_generation != s_generation) {
+        m_provider = provider;
+        m_generation = s_generation;
+        m_ref = provider->Find(m_name.c_str());
+    }
+    return m_ref ? provider : nullptr;
+}
+
+float CvarHandle::GetFloat() const
+{
+    ICvarProvider* provider = Resolve();
+    return provider ? provider->GetFloat(m_ref) : 0.0f;
+}
+
+const char* CvarHandle::GetString() const
+{
+    ICvarProvider* provider = Resolve();
+    return provider ? provider->GetString(m_ref) : "";
+}
+
+bool CvarHandle::Exists() const
+{
+    return Resolve() != nullptr;
+}
+
+} // namespace Tatoosh
@@ -0,0 +1,55 @@
+/*
+ * Tatoosh - Cvar Handle
+ *
+ * Cached reference to a cvar for values read every frame. The name is
+ * resolved through the cvar provider on first use; after that a read is a
+ * pointer dereference instead of a lookup by name. A miss is cached too: a
+ * cvar that doesn't exist yet is looked up again only after the provider is
+ * swapped or InvalidateAll is called, i.e. when a cvar has been registered.
+ *
+ * Usage:
+ *   static CvarHandle s_notifytime("con_notifytime");
+ *   double notifytime = s_notifytime.GetFloat();
+ */
+
+#ifndef TATOOSH_CVAR_HANDLE_H
+#define TATOOSH_CVAR_HANDLE_H
+
+#include <cstdint>
+#include <string>
+#include "../types/cvar_provider.h"
+
+namespace Tatoosh {
+
+class CvarHandle {
+public:
+    // Doesn't touch the provider, so handles can be statics
+    explicit CvarHandle(std::string name);
+
+    // 0 / "" when the cvar doesn't exist
+    float GetFloat() const;
+    const char* GetString() const;
+    bool Exists() const;
+
+    const std::string& GetName() const { return m_name; }
+
+    // Make every handle look its cvar up again on its next read. Call when
+    // the engine registers a cvar, so cached misses can find it.
+    static void InvalidateAll();
+
+private:
+    // Resolves on first use, and again if the provider was swapped or the
+    // handles were invalidated
+    ICvarProvider* Resolve() const;
+
+    std::string m_name;
+    mutable ICvarProvider* m_provider;
+    mutable CvarRef m_ref;
+    mutable uint32_t m_generation;
+
+    static uint32_t s_generation;
+};
+
+} // namespace Tatoosh
+
+#endif // TATOOSH_CVAR_HANDLE_H
@@ -6,6 +6,10 @@
 
 #include "game_data_model.h"
 #include "notification_model.h"
+#include "scoreboard_model.h"
+#include "hud_events.h"
+#include "game_state_history.h"
+#include "model_subscriptions.h"
 
 // Quake stat indices (from quakedef.h)
 #define STAT_HEALTH         0
@@ -54,6 +58,20 @@ namespace Tatoosh {
 // Global game state
 GameState g_game_state;
 
+// Computed functions that only read active_weapon
+static const char* const ACTIVE_WEAPON_FUNCS[] = {
+    "weapon_label", "ammo_type_label", "is_axe",
+    "is_shells_weapon", "is_nails_weapon", "is_rockets_weapon", "is_cells_weapon",
+};
+
+// Strings compare in place, so an unchanged name is neither copied nor reallocated
+static void SyncString(std::string& field, const char* value, const char* name)
+{
+    if (!value || field == value) return;
+    field = value;
+    GameDataModel::DirtyVariable(name);
+}
+
 // Static members
 Rml::DataModelHandle GameDataModel::s_model_handle;
 bool GameDataModel::s_initialized = false;
@@ -76,73 +94,28 @@ bool GameDataModel::Initialize(Rml::Context* context)
         return false;
     }
 
-    // Bind core stats
-    constructor.Bind("health", &g_game_state.health);
-    constructor.Bind("armor", &g_game_state.armor);
-    constructor.Bind("ammo", &g_game_state.ammo);
-    constructor.Bind("active_weapon", &g_game_state.active_weapon);
-
-    // Bind ammo counts
-    constructor.Bind("shells", &g_game_state.shells);
-    constructor.Bind("nails", &g_game_state.nails);
-    constructor.Bind("rockets", &g_game_state.rockets);
-    constructor.Bind("cells", &g_game_state.cells);
-
-    // Bind level statistics
-    constructor.Bind("monsters", &g_game_state.monsters);
-    constructor.Bind("total_monsters", &g_game_state.total_monsters);
-    constructor.Bind("secrets", &g_game_state.secrets);
-    constructor.Bind("total_secrets", &g_game_state.total_secrets);
-
-    // Bind weapon ownership
-    constructor.Bind("has_shotgun", &g_game_state.has_shotgun);
-    constructor.Bind("has_super_shotgun", &g_game_state.has_super_shotgun);
-    constructor.Bind("has_nailgun", &g_game_state.has_nailgun);
-    constructor.Bind("has_super_nailgun", &g_game_state.has_super_nailgun);
-    constructor.Bind("has_grenade_launcher", &g_game_state.has_grenade_launcher);
-    constructor.Bind("has_rocket_launcher", &g_game_state.has_rocket_launcher);
-    constructor.Bind("has_lightning_gun", &g_game_state.has_lightning_gun);
-
-    // Bind keys
-    constructor.Bind("has_key1", &g_game_state.has_key1);
-    constructor.Bind("has_key2", &g_game_state.has_key2);
-
-    // Bind powerups
-    constructor.Bind("has_invisibility", &g_game_state.has_invisibility);
-    constructor.Bind("has_invulnerability", &g_game_state.has_invulnerability);
-    constructor.Bind("has_suit", &g_game_state.has_suit);
-    constructor.Bind("has_quad", &g_game_state.has_quad);
-
-    // Bind sigils
-    constructor.Bind("has_sigil1", &g_game_state.has_sigil1);
-    constructor.Bind("has_sigil2", &g_game_state.has_sigil2);
-    constructor.Bind("has_sigil3", &g_game_state.has_sigil3);
-    constructor.Bind("has_sigil4", &g_game_state.has_sigil4);
-
-    // Bind armor type
-    constructor.Bind("armor_type", &g_game_state.armor_type);
-
-    // Bind game state flags
-    constructor.Bind("intermission", &g_game_state.intermission);
-    constructor.Bind("deathmatch", &g_game_state.deathmatch);
-    constructor.Bind("coop", &g_game_state.coop);
+    // Stats bind straight to their slot in the stat block
+    for (size_t i = 0; i < GAME_STAT_COUNT; ++i) {
+        constructor.Bind(GAME_STAT_NAMES[i], &g_game_state.stats.values[i]);
+    }
+
+    // Flags are bits, so each is read through a getter
+    for (size_t i = 0; i < GAME_FLAG_COUNT; ++i) {
+        GameFlag flag = static_cast<GameFlag>(i);
+        constructor.BindFunc(GAME_FLAG_NAMES[i],
+            [flag](Rml::Variant& variant) {
+                variant = g_game_state.stats.Has(flag);
+            });
+    }
 
     // Bind level info
     constructor.Bind("level_name", &g_game_state.level_name);
     constructor.Bind("map_name", &g_game_state.map_name);
 
-    // Bind time
-    constructor.Bind("time_minutes", &g_game_state.time_minutes);
-    constructor.Bind("time_seconds", &g_game_state.time_seconds);
-
-    // Bind face state
-    constructor.Bind("face_index", &g_game_state.face_index);
-    constructor.Bind("face_pain", &g_game_state.face_pain);
-
     // Computed: weapon label from active_weapon bitflag
     constructor.BindFunc("weapon_label",
         [](Rml::Variant& variant) {
-            switch (g_game_state.active_weapon) {
+            switch (g_game_state.stats[GameStat::active_weapon]) {
                 case 4096: variant = Rml::String("AXE"); break;
                 case 1:    variant = Rml::String("SHOTGUN"); break;
                 case 2:    variant = Rml::String("SUPER SHOTGUN"); break;
@@ -158,7 +131,7 @@ bool GameDataModel::Initialize(Rml::Context* context)
     // Computed: ammo type label
     constructor.BindFunc("ammo_type_label",
         [](Rml::Variant& variant) {
-            switch (g_game_state.active_weapon) {
+            switch (g_game_state.stats[GameStat::active_weapon]) {
                 case 1:  case 2:  variant = Rml::String("SHELLS"); break;
                 case 4:  case 8:  variant = Rml::String("NAILS"); break;
                 case 16: case 32: variant = Rml::String("ROCKETS"); break;
@@ -170,40 +143,47 @@ bool GameDataModel::Initialize(Rml::Context* context)
     // Computed: is_axe (hide ammo display when wielding axe)
     constructor.BindFunc("is_axe",
         [](Rml::Variant& variant) {
-            variant = (g_game_state.active_weapon == 4096);
+            variant = (g_game_state.stats[GameStat::active_weapon] == 4096);
         });
 
     // Computed: active ammo type booleans for reserves highlight
     constructor.BindFunc("is_shells_weapon",
         [](Rml::Variant& variant) {
-            int w = g_game_state.active_weapon;
+            int w = g_game_state.stats[GameStat::active_weapon];
             variant = (w == 1 || w == 2);
         });
 
     constructor.BindFunc("is_nails_weapon",
         [](Rml::Variant& variant) {
-            int w = g_game_state.active_weapon;
+            int w = g_game_state.stats[GameStat::active_weapon];
             variant = (w == 4 || w == 8);
         });
 
     constructor.BindFunc("is_rockets_weapon",
         [](Rml::Variant& variant) {
-            int w = g_game_state.active_weapon;
+            int w = g_game_state.stats[GameStat::active_weapon];
             variant = (w == 16 || w == 32);
         });
 
     constructor.BindFunc("is_cells_weapon",
         [](Rml::Variant& variant) {
-            variant = (g_game_state.active_weapon == 64);
+            variant = (g_game_state.stats[GameStat::active_weapon] == 64);
         });
 
     // Register notification bindings on the same "game" model
     NotificationModel::RegisterBindings(constructor);
 
+    // Register the deathmatch player list on the same "game" model
+    ScoreboardModel::RegisterBindings(constructor);
+
     s_model_handle = constructor.GetModelHandle();
 
     // Share the model handle with NotificationModel for selective dirtying
     NotificationModel::SetModelHandle(s_model_handle);
+    ScoreboardModel::SetModelHandle(s_model_handle);
+
+    // Syncs are skipped while no document shows the model; catch up when one does
+    ModelSubscriptions::Register("game", &GameDataModel::MarkAllDirty);
 
     s_initialized = true;
 
@@ -216,6 +196,9 @@ void GameDataModel::Shutdown()
     if (!s_initialized) return;
 
     NotificationModel::Shutdown();
+    ScoreboardModel::Shutdown();
+    HudEvents::Clear();
+    ModelSubscriptions::Unregister("game");
 
     // RmlUI handles cleanup when context is destroyed
     s_model_handle = Rml::DataModelHandle();
@@ -228,8 +211,8 @@ void GameDataModel::Update()
 {
     if (!s_initialized || !s_model_handle) return;
 
-    // Mark the model as dirty so RmlUI re-evaluates bindings
-    s_model_handle.DirtyAllVariables();
+    // Nothing to do per frame: GameDataModel_SyncFromQuake dirties each
+    // variable as it changes, and RmlUI only re-evaluates those.
 }
 
 void GameDataModel::MarkAllDirty()
@@ -238,6 +221,54 @@ void GameDataModel::MarkAllDirty()
     s_model_handle.DirtyAllVariables();
 }
 
+void GameDataModel::DirtyVariable(const char* name)
+{
+    if (!s_initialized || !s_model_handle) return;
+    s_model_handle.DirtyVariable(name);
+}
+
+void GameDataModel::ApplyStats(const GameStats& stats)
+{
+    GameStatsDiff diff = DiffGameStats(g_game_state.stats, stats);
+    if (!diff.Any()) return;
+
+    // Reactions (pickups, damage) are derived from the same diff
+    HudEvents::Collect(g_game_state.stats, stats, diff);
+
+    g_game_state.stats = stats;
+
+    for (size_t i = 0; i < GAME_STAT_COUNT; ++i) {
+        if (diff.stats & (1u << i)) {
+            DirtyVariable(GAME_STAT_NAMES[i]);
+        }
+    }
+    for (size_t i = 0; i < GAME_FLAG_COUNT; ++i) {
+        if (diff.flags & (1u << i)) {
+            DirtyVariable(GAME_FLAG_NAMES[i]);
+        }
+    }
+
+    // The computed weapon functions only follow active_weapon
+    if (diff.stats & (1u << static_cast<uint32_t>(GameStat::active_weapon))) {
+        for (const char* name : ACTIVE_WEAPON_FUNCS) {
+            DirtyVariable(name);
+        }
+    }
+}
+
+void GameDataModel::PrintState()
+{
+    const GameStats& stats = g_game_state.stats;
+    for (size_t i = 0; i < GAME_STAT_COUNT; ++i) {
+        Con_Printf("%-22s %d\n", GAME_STAT_NAMES[i], stats.values[i]);
+    }
+    for (size_t i = 0; i < GAME_FLAG_COUNT; ++i) {
+        Con_Printf("%-22s %s\n", GAME_FLAG_NAMES[i], stats.Has(static_cast<GameFlag>(i)) ? "yes" : "no");
+    }
+    Con_Printf("%-22s %s\n", "level_name", g_game_state.level_name.c_str());
+    Con_Printf("%-22s %s\n", "map_name", g_game_state.map_name.c_str());
+}
+
 bool GameDataModel::IsInitialized()
 {
     return s_initialized;
@@ -265,6 +296,11 @@ void GameDataModel_Update(void)
     Tatoosh::GameDataModel::Update();
 }
 
+void GameDataModel_PrintState(void)
+{
+    Tatoosh::GameDataModel::PrintState();
+}
+
 void GameDataModel_SyncFromQuake(const int* stats, int items,
                                   int intermission, int gametype,
                                   int maxclients,
@@ -275,91 +311,108 @@ void GameDataModel_SyncFromQuake(const int* stats, int items,
 
     if (!stats) return;
 
-    // Sync core stats
-    g_game_state.health = stats[STAT_HEALTH];
-    g_game_state.armor = stats[STAT_ARMOR];
-    g_game_state.ammo = stats[STAT_AMMO];
-    g_game_state.active_weapon = stats[STAT_ACTIVEWEAPON];
+    // Build the new block from a copy, so flags Quake doesn't report (face_pain) carry over
+    GameStats next = g_game_state.stats;
+
+    // Core stats
+    next[GameStat::health] = stats[STAT_HEALTH];
+    next[GameStat::armor] = stats[STAT_ARMOR];
+    next[GameStat::ammo] = stats[STAT_AMMO];
+    next[GameStat::active_weapon] = stats[STAT_ACTIVEWEAPON];
 
-    // Sync ammo counts
-    g_game_state.shells = stats[STAT_SHELLS];
-    g_game_state.nails = stats[STAT_NAILS];
-    g_game_state.rockets = stats[STAT_ROCKETS];
-    g_game_state.cells = stats[STAT_CELLS];
+    // Ammo counts
+    next[GameStat::shells] = stats[STAT_SHELLS];
+    next[GameStat::nails] = stats[STAT_NAILS];
+    next[GameStat::rockets] = stats[STAT_ROCKETS];
+    next[GameStat::cells] = stats[STAT_CELLS];
 
-    // Sync level statistics
-    g_game_state.monsters = stats[STAT_MONSTERS];
-    g_game_state.total_monsters = stats[STAT_TOTALMONSTERS];
-    g_game_state.secrets = stats[STAT_SECRETS];
-    g_game_state.total_secrets = stats[STAT_TOTALSECRETS];
+    // Level statistics
+    next[GameStat::monsters] = stats[STAT_MONSTERS];
+    next[GameStat::total_monsters] = stats[STAT_TOTALMONSTERS];
+    next[GameStat::secrets] = stats[STAT_SECRETS];
+    next[GameStat::total_secrets] = stats[STAT_TOTALSECRETS];
 
     // Decode item bitflags for weapons
-    g_game_state.has_shotgun = (items & IT_SHOTGUN) != 0;
-    g_game_state.has_super_shotgun = (items & IT_SUPER_SHOTGUN) != 0;
-    g_game_state.has_nailgun = (items & IT_NAILGUN) != 0;
-    g_game_state.has_super_nailgun = (items & IT_SUPER_NAILGUN) != 0;
-    g_game_state.has_grenade_launcher = (items & IT_GRENADE_LAUNCHER) != 0;
-    g_game_state.has_rocket_launcher = (items & IT_ROCKET_LAUNCHER) != 0;
-    g_game_state.has_lightning_gun = (items & IT_LIGHTNING) != 0;
+    next.Set(GameFlag::has_shotgun, (items & IT_SHOTGUN) != 0);
+    next.Set(GameFlag::has_super_shotgun, (items & IT_SUPER_SHOTGUN) != 0);
+    next.Set(GameFlag::has_nailgun, (items & IT_NAILGUN) != 0);
+    next.Set(GameFlag::has_super_nailgun, (items & IT_SUPER_NAILGUN) != 0);
+    next.Set(GameFlag::has_grenade_launcher, (items & IT_GRENADE_LAUNCHER) != 0);
+    next.Set(GameFlag::has_rocket_launcher, (items & IT_ROCKET_LAUNCHER) != 0);
+    next.Set(GameFlag::has_lightning_gun, (items & IT_LIGHTNING) != 0);
 
     // Decode keys
-    g_game_state.has_key1 = (items & IT_KEY1) != 0;
-    g_game_state.has_key2 = (items & IT_KEY2) != 0;
+    next.Set(GameFlag::has_key1, (items & IT_KEY1) != 0);
+    next.Set(GameFlag::has_key2, (items & IT_KEY2) != 0);
 
     // Decode powerups
-    g_game_state.has_invisibility = (items & IT_INVISIBILITY) != 0;
-    g_game_state.has_invulnerability = (items & IT_INVULNERABILITY) != 0;
-    g_game_state.has_suit = (items & IT_SUIT) != 0;
-    g_game_state.has_quad = (items & IT_QUAD) != 0;
+    next.Set(GameFlag::has_invisibility, (items & IT_INVISIBILITY) != 0);
+    next.Set(GameFlag::has_invulnerability, (items & IT_INVULNERABILITY) != 0);
+    next.Set(GameFlag::has_suit, (items & IT_SUIT) != 0);
+    next.Set(GameFlag::has_quad, (items & IT_QUAD) != 0);
 
     // Decode sigils
-    g_game_state.has_sigil1 = (items & IT_SIGIL1) != 0;
-    g_game_state.has_sigil2 = (items & IT_SIGIL2) != 0;
-    g_game_state.has_sigil3 = (items & IT_SIGIL3) != 0;
-    g_game_state.has_sigil4 = (items & IT_SIGIL4) != 0;
+    next.Set(GameFlag::has_sigil1, (items & IT_SIGIL1) != 0);
+    next.Set(GameFlag::has_sigil2, (items & IT_SIGIL2) != 0);
+    next.Set(GameFlag::has_sigil3, (items & IT_SIGIL3) != 0);
+    next.Set(GameFlag::has_sigil4, (items & IT_SIGIL4) != 0);
 
     // Determine armor type from items
     if (items & IT_ARMOR3) {
-        g_game_state.armor_type = 3;  // Red
+        next[GameStat::armor_type] = 3;  // Red
     } else if (items & IT_ARMOR2) {
-        g_game_state.armor_type = 2;  // Yellow
+        next[GameStat::armor_type] = 2;  // Yellow
     } else if (items & IT_ARMOR1) {
-        g_game_state.armor_type = 1;  // Green
+        next[GameStat::armor_type] = 1;  // Green
     } else {
-        g_game_state.armor_type = 0;  // None
+        next[GameStat::armor_type] = 0;  // None
     }
 
     // Game state
-    g_game_state.intermission = (intermission != 0);
-    g_game_state.deathmatch = (gametype != 0);
-    g_game_state.coop = (gametype == 0 && maxclients > 1);
-
-    // Level info
-    if (level_name) {
-        g_game_state.level_name = level_name;
-    }
-    if (map_name) {
-        g_game_state.map_name = map_name;
-    }
+    next.Set(GameFlag::intermission, intermission != 0);
+    next.Set(GameFlag::deathmatch, gametype != 0);
+    next.Set(GameFlag::coop, gametype == 0 && maxclients > 1);
 
     // Time calculation
     int total_seconds = static_cast<int>(game_time);
-    g_game_state.time_minutes = total_seconds / 60;
-    g_game_state.time_seconds = total_seconds % 60;
+    next[GameStat::time_minutes] = total_seconds / 60;
+    next[GameStat::time_seconds] = total_seconds % 60;
 
     // Calculate face index based on health
-    int health = g_game_state.health;
+    int health = next[GameStat::health];
     if (health >= 100) {
-        g_game_state.face_index = 4;
+        next[GameStat::face_index] = 4;
     } else if (health >= 80) {
-        g_game_state.face_index = 3;
+        next[GameStat::face_index] = 3;
     } else if (health >= 60) {
-        g_game_state.face_index = 2;
+        next[GameStat::face_index] = 2;
     } else if (health >= 40) {
-        g_game_state.face_index = 1;
+        next[GameStat::face_index] = 1;
     } else {
-        g_game_state.face_index = 0;
+        next[GameStat::face_index] = 0;
     }
+
+    // History keeps recording while nothing displays the model
+    g_game_state_history.Append(game_time, next);
+
+    // While no document displays the game model, g_game_state is kept
+    // current without dirtying anything or raising HUD events; the catch-up
+    // when it is shown again dirties every variable. Diffing against a block
+    // left stale by the hidden period would report changes that happened
+    // long ago as this frame's damage and pickups.
+    if (!ModelSubscriptions::IsVisible("game")) {
+        g_game_state.stats = next;
+        if (level_name && g_game_state.level_name != level_name) g_game_state.level_name = level_name;
+        if (map_name && g_game_state.map_name != map_name) g_game_state.map_name = map_name;
+        return;
+    }
+
+    // One compare of the whole block finds what changed
+    GameDataModel::ApplyStats(next);
+
+    // Level info
+    SyncString(g_game_state.level_name, level_name, "level_name");
+    SyncString(g_game_state.map_name, map_name, "map_name");
 }
 
 } // extern "C"
@@ -2,8 +2,9 @@
  * Tatoosh - Game Data Model
  *
  * Synchronizes Quake game state (cl.stats[], cl.items) to RmlUI data model.
- * The data model is automatically updated each frame and can be used in
- * RML documents via data binding expressions.
+ * Each sync compares against the previous state and dirties only the
+ * variables (and computed functions) whose inputs changed. The model can be
+ * used in RML documents via data binding expressions.
  *
  * Usage in RML:
  *   <body data-model="game">
@@ -39,6 +40,16 @@ public:
     // Force a dirty check on all variables (call after level load)
     static void MarkAllDirty();
 
+    // Dirty a single variable or computed function (no-op before Initialize)
+    static void DirtyVariable(const char* name);
+
+    // Store a new stat block, dirtying only the stats and flags that differ
+    // and queueing the HUD events they imply
+    static void ApplyStats(const GameStats& stats);
+
+    // Dump every stat and flag to the console
+    static void PrintState();
+
     // Check if initialized
     static bool IsInitialized();
 
@@ -74,6 +85,9 @@ void GameDataModel_SyncFromQuake(const int* stats, int items,
                                   const char* level_name, const char* map_name,
                                   double game_time);
 
+// Print the synced game state to the console
+void GameDataModel_PrintState(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,213 @@
+/*
+ * Tatoosh - Game State History Implementation
+ */
+
+#include "game_state_history.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Tatoosh {
+
+GameStateHistory g_game_state_history;
+
+GameStateHistory::GameStateHistory(size_t budget_bytes)
+    : m_head(0)
+    , m_used(0)
+    , m_key_first(0)
+    , m_key_count(0)
+    , m_first_record(0)
+    , m_next_record(0)
+    , m_last{}
+    , m_last_time(0.0)
+{
+    // Evicting a group must always leave room for the group being written
+    size_t minimum = MAX_RECORD_BYTES * KEYFRAME_INTERVAL * 2;
+    m_buffer.resize(std::max(budget_bytes, minimum));
+    m_keyframes.resize(m_buffer.size() / (MIN_RECORD_BYTES * KEYFRAME_INTERVAL) + 2);
+}
+
+void GameStateHistory::Append(double time, const GameStats& stats)
+{
+    // Several syncs within one millisecond (or a paused game) add nothing;
+    // time going backwards is a new map or a demo restart
+    if (m_next_record != m_first_record) {
+        if (time < m_last_time - 0.0005) {
+            Clear();
+        } else if (time < m_last_time + 0.0005) {
+            return;
+        }
+    }
+
+    while (m_buffer.size() - m_used < MAX_RECORD_BYTES) {
+        EvictOldestGroup();
+    }
+
+    size_t start = m_head;
+    bool keyframe = (m_next_record - m_first_record) % KEYFRAME_INTERVAL == 0;
+
+    if (keyframe) {
+        m_keyframes[(m_key_first + m_key_count) % m_keyframes.size()] = {m_next_record, start};
+        m_key_count++;
+
+        WriteDouble(time);
+        for (size_t i = 0; i < GAME_STAT_COUNT; ++i) {
+            WriteSigned(stats.values[i]);
+        }
+        WriteVarint(stats.flags);
+        m_last_time = time;
+    } else {
+        // Milliseconds since the last record, accumulated as decoded so
+        // rounding doesn't drift
+        double delta_ms = std::max(0.0, std::round((time - m_last_time) * 1000.0));
+        uint32_t ms = static_cast<uint32_t>(std::min(delta_ms, 4294967295.0));
+        WriteVarint(ms);
+        m_last_time += ms / 1000.0;
+
+        GameStatsDiff diff = DiffGameStats(m_last, stats);
+        WriteVarint(diff.stats);
+        for (size_t i = 0; i < GAME_STAT_COUNT; ++i) {
+            if (diff.stats & (1u << i)) {
+                WriteSigned(stats.values[i] - m_last.values[i]);
+            }
+        }
+        WriteVarint(diff.flags);
+    }
+
+    m_used += (m_head + m_buffer.size() - start) % m_buffer.size();
+    m_last = stats;
+    m_next_record++;
+}
+
+void GameStateHistory::Clear()
+{
+    m_head = 0;
+    m_used = 0;
+    m_key_first = 0;
+    m_key_count = 0;
+    m_first_record = 0;
+    m_next_record = 0;
+    m_last = GameStats{};
+    m_last_time = 0.0;
+}
+
+bool GameStateHistory::Get(size_t index, GameStateSample& sample) const
+{
+    if (index >= Size()) return false;
+
+    size_t group = index / KEYFRAME_INTERVAL;
+    Reader reader{m_buffer, KeyframeAt(group).offset};
+    ReadKeyframe(reader, sample);
+
+    for (size_t i = group * KEYFRAME_INTERVAL; i < index; ++i) {
+        ReadDelta(reader, sample);
+    }
+    return true;
+}
+
+size_t GameStateHistory::SampleStat(GameStat stat, float* values, size_t count) const
+{
+    size_t size = Size();
+    if (size == 0 || count == 0) return 0;
+
+    count = std::min(count, size);
+    GameStateSample sample;
+    for (size_t i = 0; i < count; ++i) {
+        size_t index = count > 1 ? i * (size - 1) / (count - 1) : size - 1;
+        Get(index, sample);
+        values[i] = static_cast<float>(sample.stats[stat]);
+    }
+    return count;
+}
+
+void GameStateHistory::EvictOldestGroup()
+{
+    // The budget holds at least two groups, so the one being written survives
+    if (m_key_count < 2) {
+        Clear();
+        return;
+    }
+
+    const Keyframe& next = KeyframeAt(1);
+    m_used -= (next.offset + m_buffer.size() - KeyframeAt(0).offset) % m_buffer.size();
+    m_first_record = next.record;
+    m_key_first = (m_key_first + 1) % m_keyframes.size();
+    m_key_count--;
+}
+
+void GameStateHistory::ReadKeyframe(Reader& reader, GameStateSample& sample)
+{
+    sample.time = reader.Double();
+    for (size_t i = 0; i < GAME_STAT_COUNT; ++i) {
+        sample.stats.values[i] = reader.Signed();
+    }
+    sample.stats.flags = reader.Varint();
+}
+
+void GameStateHistory::ReadDelta(Reader& reader, GameStateSample& sample)
+{
+    sample.time += reader.Varint() / 1000.0;
+
+    uint32_t mask = reader.Varint();
+    for (size_t i = 0; i < GAME_STAT_COUNT; ++i) {
+        if (mask & (1u << i)) {
+            sample.stats.values[i] += reader.Signed();
+        }
+    }
+    sample.stats.flags ^= reader.Varint();
+}
+
+void GameStateHistory::WriteByte(uint8_t byte)
+{
+    m_buffer[m_head] = byte;
+    m_head = (m_head + 1) % m_buffer.size();
+}
+
+void GameStateHistory::WriteVarint(uint32_t value)
+{
+    while (value >= 0x80) {
+        WriteByte(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    WriteByte(static_cast<uint8_t>(value));
+}
+
+void GameStateHistory::WriteDouble(double value)
+{
+    uint8_t bytes[sizeof(double)];
+    memcpy(bytes, &value, sizeof(double));
+    for (uint8_t byte : bytes) {
+        WriteByte(byte);
+    }
+}
+
+uint8_t GameStateHistory::Reader::Byte()
+{
+    uint8_t byte = buffer[offset];
+    offset = (offset + 1) % buffer.size();
+    return byte;
+}
+
+uint32_t GameStateHistory::Reader::Varint()
+{
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t byte = Byte();
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return value;
+}
+
+double GameStateHistory::Reader::Double()
+{
+    uint8_t bytes[sizeof(double)];
+    for (uint8_t& byte : bytes) {
+        byte = Byte();
+    }
+    double value;
+    memcpy(&value, bytes, sizeof(double));
+    return value;
+}
+
+} // namespace Tatoosh
@@ -0,0 +1,104 @@
+/*
+ * Tatoosh - Game State History
+ *
+ * Fixed-memory ring of GameStats snapshots, one per sync, for death recaps,
+ * intermission graphs and scrubbing. Most records are deltas against the
+ * previous one: a mask of the stats that changed, their zigzag varint
+ * differences and the flags XOR, usually a handful of bytes. Every
+ * KEYFRAME_INTERVAL records is a full keyframe, so any record decodes from
+ * at most KEYFRAME_INTERVAL - 1 deltas. When the budget is full, the oldest
+ * keyframe and its deltas are dropped.
+ */
+
+#ifndef TATOOSH_GAME_STATE_HISTORY_H
+#define TATOOSH_GAME_STATE_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../types/game_state.h"
+
+namespace Tatoosh {
+
+// One decoded record
+struct GameStateSample {
+    double time;
+    GameStats stats;
+};
+
+class GameStateHistory {
+public:
+    static constexpr size_t DEFAULT_BUDGET = 256 * 1024;
+    static constexpr uint32_t KEYFRAME_INTERVAL = 32;
+
+    explicit GameStateHistory(size_t budget_bytes = DEFAULT_BUDGET);
+
+    // Record a snapshot. Amortized O(1). A snapshot within a millisecond of the
+    // last is dropped; time going backwards starts over.
+    void Append(double time, const GameStats& stats);
+    void Clear();
+
+    // Records held, oldest first
+    size_t Size() const { return static_cast<size_t>(m_next_record - m_first_record); }
+    bool Get(size_t index, GameStateSample& sample) const;
+
+    // One stat at count evenly spaced records across the history, oldest first.
+    // Returns the number of values written.
+    size_t SampleStat(GameStat stat, float* values, size_t count) const;
+
+    size_t GetMemoryUsed() const { return m_used; }
+    size_t GetBudget() const { return m_buffer.size(); }
+
+private:
+    // Worst case: keyframe time + every stat + flags, at 5 bytes per varint
+    static constexpr size_t MAX_RECORD_BYTES = sizeof(double) + (GAME_STAT_COUNT + 1) * 5;
+    static constexpr size_t MIN_RECORD_BYTES = 3;   // Time, empty mask, no flag change
+
+    struct Keyframe {
+        uint64_t record;      // Absolute record number
+        size_t offset;        // Byte offset in m_buffer
+    };
+
+    // Byte cursor that wraps around the ring
+    struct Reader {
+        const std::vector<uint8_t>& buffer;
+        size_t offset;
+
+        uint8_t Byte();
+        uint32_t Varint();
+        int32_t Signed() { uint32_t v = Varint(); return static_cast<int32_t>((v >> 1) ^ (0u - (v & 1u))); }
+        double Double();
+    };
+
+    void WriteByte(uint8_t byte);
+    void WriteVarint(uint32_t value);
+    void WriteSigned(int32_t value) { WriteVarint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31)); }
+    void WriteDouble(double value);
+
+    void EvictOldestGroup();
+    const Keyframe& KeyframeAt(size_t group) const { return m_keyframes[(m_key_first + group) % m_keyframes.size()]; }
+    static void ReadKeyframe(Reader& reader, GameStateSample& sample);
+    static void ReadDelta(Reader& reader, GameStateSample& sample);
+
+    std::vector<uint8_t> m_buffer;
+    size_t m_head;            // Next byte to write
+    size_t m_used;            // Bytes between the oldest record and m_head
+
+    std::vector<Keyframe> m_keyframes;   // Ring, sized for the most groups the budget can hold
+    size_t m_key_first;
+    size_t m_key_count;
+
+    uint64_t m_first_record;  // Always a keyframe
+    uint64_t m_next_record;
+
+    // Last record written, what the next delta is taken against
+    GameStats m_last;
+    double m_last_time;
+};
+
+// History of g_game_state, appended on every game state sync
+extern GameStateHistory g_game_state_history;
+
+} // namespace Tatoosh
+
+#endif // TATOOSH_GAME_STATE_HISTORY_H
@@ -0,0 +1,158 @@
+/*
+ * Tatoosh - HUD Events Implementation
+ */
+
+#include "hud_events.h"
+#include <cstring>
+
+namespace Tatoosh {
+
+// Indexed by HudEventType
+static const char* const EVENT_NAMES[] = {
+    "healthlost", "healthgained", "armorlost", "armorgained", "armortierchanged",
+    "weaponswitched", "itemacquired", "itemlost", "ammolow",
+};
+static const char* const PULSE_CLASSES[] = {
+    "hud-healthlost", "hud-healthgained", "hud-armorlost", "hud-armorgained", "hud-armortierchanged",
+    "hud-weaponswitched", "hud-itemacquired", "hud-itemlost", "hud-ammolow",
+};
+static_assert(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) == static_cast<size_t>(HudEventType::Count),
+              "one name per event");
+static_assert(sizeof(PULSE_CLASSES) / sizeof(PULSE_CLASSES[0]) == static_cast<size_t>(HudEventType::Count),
+              "one class per event");
+
+// Flags that are inventory (weapons, keys, powerups, sigils), as opposed to game mode
+static constexpr uint32_t ITEM_FLAGS = (1u << (static_cast<uint32_t>(GameFlag::has_sigil4) + 1)) - 1u;
+
+static constexpr int AXE_WEAPON = 4096;
+
+std::vector<HudEvents::Event> HudEvents::s_queue;
+std::vector<HudEvents::Pulse> HudEvents::s_pulses;
+
+// True if the space-separated list names the event
+static bool ListsEvent(const Rml::String& list, const char* name)
+{
+    size_t length = strlen(name);
+    size_t pos = 0;
+    while ((pos = list.find(name, pos)) != Rml::String::npos) {
+        bool starts = pos == 0 || list[pos - 1] == ' ';
+        bool ends = pos + length == list.size() || list[pos + length] == ' ';
+        if (starts && ends) return true;
+        pos += length;
+    }
+    return false;
+}
+
+void HudEvents::Collect(const GameStats& before, const GameStats& after, const GameStatsDiff& diff)
+{
+    auto changed = [&diff](GameStat stat) {
+        return (diff.stats & (1u << static_cast<uint32_t>(stat))) != 0;
+    };
+
+    if (changed(GameStat::health)) {
+        int value = after[GameStat::health];
+        int previous = before[GameStat::health];
+        Queue(value < previous ? HudEventType::HealthLost : HudEventType::HealthGained, value, previous);
+    }
+
+    if (changed(GameStat::armor)) {
+        int value = after[GameStat::armor];
+        int previous = before[GameStat::armor];
+        Queue(value < previous ? HudEventType::ArmorLost : HudEventType::ArmorGained, value, previous);
+    }
+
+    if (changed(GameStat::armor_type)) {
+        Queue(HudEventType::ArmorTierChanged, after[GameStat::armor_type], before[GameStat::armor_type]);
+    }
+
+    if (changed(GameStat::active_weapon)) {
+        Queue(HudEventType::WeaponSwitched, after[GameStat::active_weapon], before[GameStat::active_weapon]);
+    } else if (changed(GameStat::ammo) && after[GameStat::active_weapon] != AXE_WEAPON) {
+        // Only a drop across the threshold with the same weapon; switching to an
+        // almost empty weapon is not news
+        int value = after[GameStat::ammo];
+        int previous = before[GameStat::ammo];
+        if (value <= LOW_AMMO_THRESHOLD && previous > LOW_AMMO_THRESHOLD) {
+            Queue(HudEventType::AmmoLow, value, previous);
+        }
+    }
+
+    uint32_t items = diff.flags & ITEM_FLAGS;
+    for (uint32_t i = 0; items != 0; ++i, items >>= 1) {
+        if (items & 1u) {
+            bool has = after.Has(static_cast<GameFlag>(i));
+            Queue(has ? HudEventType::ItemAcquired : HudEventType::ItemLost, has, !has, GAME_FLAG_NAMES[i]);
+        }
+    }
+}
+
+void HudEvents::Dispatch(Rml::Context* context)
+{
+    if (s_queue.empty() && s_pulses.empty()) return;
+
+    // Last frame's pulses end here; elements that were removed since are skipped
+    for (Pulse& pulse : s_pulses) {
+        if (Rml::Element* element = pulse.element.get()) {
+            element->SetClass(PULSE_CLASSES[static_cast<size_t>(pulse.type)], false);
+        }
+    }
+    s_pulses.clear();
+
+    if (s_queue.empty()) return;
+
+    int num_documents = context ? context->GetNumDocuments() : 0;
+    for (int i = 0; i < num_documents; ++i) {
+        Rml::ElementDocument* document = context->GetDocument(i);
+        if (!document || !document->IsVisible()) continue;
+
+        const Rml::Variant* model = document->GetAttribute("data-model");
+        if (model && model->Get<Rml::String>() == "game") {
+            DispatchToDocument(document);
+        }
+    }
+    s_queue.clear();
+}
+
+void HudEvents::Clear()
+{
+    s_queue.clear();
+    s_pulses.clear();
+}
+
+void HudEvents::Queue(HudEventType type, int value, int previous, const char* item)
+{
+    s_queue.push_back({type, value, previous, item});
+}
+
+void HudEvents::DispatchToDocument(Rml::ElementDocument* document)
+{
+    Rml::ElementList subscribers;
+    document->QuerySelectorAll(subscribers, "[data-hud-events]");
+
+    for (const Event& event : s_queue) {
+        const char* name = EVENT_NAMES[static_cast<size_t>(event.type)];
+
+        Rml::Dictionary parameters;
+        parameters["value"] = event.value;
+        parameters["previous"] = event.previous;
+        parameters["amount"] = event.value - event.previous;
+        if (event.item) {
+            parameters["item"] = Rml::String(event.item);
+        }
+
+        document->DispatchEvent(name, parameters);
+
+        // Subscribers get their own copy; it doesn't bubble, or the document
+        // would see the event once per subscriber
+        for (Rml::Element* element : subscribers) {
+            const Rml::Variant* list = element->GetAttribute("data-hud-events");
+            if (!list || !ListsEvent(list->Get<Rml::String>(), name)) continue;
+
+            element->DispatchEvent(name, parameters, false, false);
+            element->SetClass(PULSE_CLASSES[static_cast<size_t>(event.type)], true);
+            s_pulses.push_back({element->GetObserverPtr(), event.type});
+        }
+    }
+}
+
+} // namespace Tatoosh
@@ -0,0 +1,80 @@
+/*
+ * Tatoosh - HUD Events
+ *
+ * Turns game state changes into RmlUI events, so the HUD can react to a
+ * pickup or a hit instead of polling absolute values. Events are queued
+ * while syncing and dispatched once per frame; a frame where nothing
+ * happened dispatches nothing.
+ *
+ * Every visible document bound to the "game" model receives each event,
+ * as do its elements that list the event in data-hud-events. Those elements
+ * also carry the class hud-<event> for one frame, so a transition on the
+ * class gives a flash without any script:
+ *
+ *   <div class="health" data-hud-events="healthlost">{{ health }}</div>
+ *   .health { transition: color 0.4s; }
+ *   .health.hud-healthlost { color: #ff0000; }
+ *
+ * Event parameters: value, previous, amount (value - previous) and, for
+ * itemacquired/itemlost, item (the flag name, e.g. "has_quad").
+ */
+
+#ifndef TATOOSH_HUD_EVENTS_H
+#define TATOOSH_HUD_EVENTS_H
+
+#include <RmlUi/Core.h>
+#include <vector>
+#include "../types/game_state.h"
+
+namespace Tatoosh {
+
+enum class HudEventType {
+    HealthLost,
+    HealthGained,
+    ArmorLost,
+    ArmorGained,
+    ArmorTierChanged,
+    WeaponSwitched,
+    ItemAcquired,
+    ItemLost,
+    AmmoLow,        // Ammo for the held weapon dropped to LOW_AMMO_THRESHOLD
+    Count
+};
+
+class HudEvents {
+public:
+    static constexpr int LOW_AMMO_THRESHOLD = 10;
+
+    // Queue an event for each reaction-worthy difference between two snapshots
+    static void Collect(const GameStats& before, const GameStats& after, const GameStatsDiff& diff);
+
+    // Dispatch the queued events and drop last frame's hud-<event> classes.
+    // Call once per frame from UI_Update, before Context::Update.
+    static void Dispatch(Rml::Context* context);
+
+    // Drop queued events (level change, shutdown)
+    static void Clear();
+
+private:
+    struct Event {
+        HudEventType type;
+        int value;
+        int previous;
+        const char* item;     // Flag name for item events, else null
+    };
+
+    struct Pulse {
+        Rml::ObserverPtr<Rml::Element> element;
+        HudEventType type;
+    };
+
+    static void Queue(HudEventType type, int value, int previous, const char* item = nullptr);
+    static void DispatchToDocument(Rml::ElementDocument* document);
+
+    static std::vector<Event> s_queue;
+    static std::vector<Pulse> s_pulses;     // Classes to remove on the next Dispatch
+};
+
+} // namespace Tatoosh
+
+#endif // TATOOSH_HUD_EVENTS_H
@@ -0,0 +1,375 @@
+/*
+ * Tatoosh - UI Device Memory Heap Implementation
+ */
+
+#include "memory_heap.h"
+#include <RmlUi/Core/Log.h>
+
+namespace Tatoosh {
+
+static constexpr uint32_t INVALID_MEMORY_TYPE = ~0u;
+
+MemoryHeap::MemoryHeap()
+    : m_device(VK_NULL_HANDLE)
+    , m_properties{}
+    , m_dedicated_bytes(0)
+{
+}
+
+MemoryHeap::~MemoryHeap()
+{
+    Shutdown();
+}
+
+bool MemoryHeap::Initialize(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties)
+{
+    m_device = device;
+    m_properties = properties;
+    return true;
+}
+
+void MemoryHeap::Shutdown()
+{
+    for (Pool& pool : m_pools) {
+        for (Block& block : pool.blocks) {
+            ReleaseBlock(block);
+        }
+    }
+    m_pools.clear();
+
+    // Their owners should have freed them; the memory goes either way
+    if (!m_dedicated.empty()) {
+        Rml::Log::Message(Rml::Log::LT_WARNING, "MemoryHeap: Releasing %u dedicated allocations still in use",
+                          static_cast<unsigned>(m_dedicated.size()));
+    }
+    for (const Dedicated& dedicated : m_dedicated) {
+        ReleaseDedicated(dedicated);
+    }
+    m_dedicated.clear();
+    m_dedicated_bytes = 0;
+}
+
+bool MemoryHeap::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+                          MemoryKind kind, MemoryAllocation& allocation)
+{
+    uint32_t memory_type = FindMemoryType(requirements.memoryTypeBits, properties);
+    if (memory_type == INVALID_MEMORY_TYPE) {
+        return false;
+    }
+
+    // Buddies are aligned to their own size, so the order covers both size and alignment
+    VkDeviceSize needed = requirements.size > requirements.alignment ? requirements.size
+                                                                     : requirements.alignment;
+    uint32_t order = 0;
+    while (OrderSize(order) < needed) {
+        ++order;
+    }
+
+    int pool_index = FindOrCreatePool(memory_type, kind);
+    Pool& pool = m_pools[pool_index];
+
+    // Anything bigger than half a block would waste most of one; give it its own memory
+    if (OrderSize(order) > pool.block_size / 2) {
+        if (!AllocateDedicated(requirements.size, memory_type, allocation)) {
+            return false;
+        }
+        allocation.requested = requirements.size;
+        return true;
+    }
+
+    bool found = false;
+    for (uint32_t i = 0; i < pool.blocks.size() && !found; ++i) {
+        if (pool.blocks[i].memory != VK_NULL_HANDLE) {
+            found = AllocateFromBlock(pool, i, order, allocation);
+        }
+    }
+
+    if (!found) {
+        int block_index = CreateBlock(pool);
+        if (block_index < 0 ||
+            !AllocateFromBlock(pool, static_cast<uint32_t>(block_index), order, allocation)) {
+            return false;
+        }
+    }
+
+    allocation.pool = pool_index;
+    allocation.requested = requirements.size;
+    pool.allocation_count++;
+    pool.requested_bytes += requirements.size;
+    return true;
+}
+
+void MemoryHeap::Free(MemoryAllocation& allocation)
+{
+    if (allocation.memory == VK_NULL_HANDLE) return;
+
+    if (allocation.pool < 0) {
+        for (size_t i = 0; i < m_dedicated.size(); ++i) {
+            if (m_dedicated[i].memory == allocation.memory) {
+                ReleaseDedicated(m_dedicated[i]);
+                m_dedicated[i] = m_dedicated.back();
+                m_dedicated.pop_back();
+                m_dedicated_bytes -= allocation.size;
+                break;
+            }
+        }
+        allocation = MemoryAllocation{};
+        return;
+    }
+
+    Pool& pool = m_pools[allocation.pool];
+    Block& block = pool.blocks[allocation.block];
+
+    pool.allocation_count--;
+    pool.requested_bytes -= allocation.requested;
+    block.used -= allocation.size;
+
+    // Merge with the buddy for as long as it is free too
+    VkDeviceSize offset = allocation.offset;
+    uint32_t order = allocation.order;
+    while (order < pool.max_order) {
+        VkDeviceSize buddy = offset ^ OrderSize(order);
+        if (block.free_lists[order].erase(buddy) == 0) {
+            break;
+        }
+        offset = offset < buddy ? offset : buddy;
+        ++order;
+    }
+    block.free_lists[order].insert(offset);
+
+    // Keep one empty block around so menus opening and closing don't churn
+    // vkAllocateMemory; release any further empty blocks.
+    if (block.used == 0) {
+        for (const Block& other : pool.blocks) {
+            if (&other != &block && other.memory != VK_NULL_HANDLE && other.used == 0) {
+                ReleaseBlock(block);
+                break;
+            }
+        }
+    }
+
+    allocation = MemoryAllocation{};
+}
+
+MemoryHeapStats MemoryHeap::GetStats() const
+{
+    MemoryHeapStats stats{};
+    for (const MemoryPoolStats& pool : GetPoolStats()) {
+        stats.block_count += pool.block_count;
+        stats.allocation_count += pool.allocation_count;
+        stats.reserved_bytes += pool.reserved_bytes;
+        stats.used_bytes += pool.used_bytes;
+        stats.requested_bytes += pool.requested_bytes;
+        if (pool.largest_free > stats.largest_free) {
+            stats.largest_free = pool.largest_free;
+        }
+    }
+
+    stats.dedicated_count = static_cast<uint32_t>(m_dedicated.size());
+    stats.dedicated_bytes = m_dedicated_bytes;
+
+    if (stats.used_bytes > 0) {
+        stats.internal_fragmentation =
+            1.0f - static_cast<float>(stats.requested_bytes) / static_cast<float>(stats.used_bytes);
+    }
+
+    VkDeviceSize free_bytes = stats.reserved_bytes - stats.used_bytes;
+    if (free_bytes > 0) {
+        stats.external_fragmentation =
+            1.0f - static_cast<float>(stats.largest_free) / static_cast<float>(free_bytes);
+    }
+    return stats;
+}
+
+std::vector<MemoryPoolStats> MemoryHeap::GetPoolStats() const
+{
+    std::vector<MemoryPoolStats> result;
+    result.reserve(m_pools.size());
+
+    for (const Pool& pool : m_pools) {
+        MemoryPoolStats stats{};
+        stats.memory_type = pool.memory_type;
+        stats.kind = pool.kind;
+        stats.host_visible = pool.host_visible;
+        stats.allocation_count = pool.allocation_count;
+        stats.requested_bytes = pool.requested_bytes;
+
+        for (const Block& block : pool.blocks) {
+            if (block.memory == VK_NULL_HANDLE) continue;
+            stats.block_count++;
+            stats.reserved_bytes += pool.block_size;
+            stats.used_bytes += block.used;
+
+            VkDeviceSize largest = LargestFree(block, pool);
+            if (largest > stats.largest_free) {
+                stats.largest_free = largest;
+            }
+        }
+        result.push_back(stats);
+    }
+    return result;
+}
+
+uint32_t MemoryHeap::FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties) const
+{
+    for (uint32_t i = 0; i < m_properties.memoryTypeCount; i++) {
+        if ((type_filter & (1u << i)) &&
+            (m_properties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+    return INVALID_MEMORY_TYPE;
+}
+
+int MemoryHeap::FindOrCreatePool(uint32_t memory_type, MemoryKind kind)
+{
+    for (size_t i = 0; i < m_pools.size(); ++i) {
+        if (m_pools[i].memory_type == memory_type && m_pools[i].kind == kind) {
+            return static_cast<int>(i);
+        }
+    }
+
+    Pool pool{};
+    pool.memory_type = memory_type;
+    pool.kind = kind;
+    pool.host_visible = (m_properties.memoryTypes[memory_type].propertyFlags &
+                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+    pool.block_size = pool.host_visible ? HOST_BLOCK_SIZE : DEVICE_BLOCK_SIZE;
+    while (OrderSize(pool.max_order) < pool.block_size) {
+        pool.max_order++;
+    }
+
+    m_pools.push_back(std::move(pool));
+    return static_cast<int>(m_pools.size() - 1);
+}
+
+int MemoryHeap::CreateBlock(Pool& pool)
+{
+    VkMemoryAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = pool.block_size;
+    alloc_info.memoryTypeIndex = pool.memory_type;
+
+    Block block{};
+    if (vkAllocateMemory(m_device, &alloc_info, nullptr, &block.memory) != VK_SUCCESS) {
+        Rml::Log::Message(Rml::Log::LT_ERROR, "MemoryHeap: Failed to allocate %llu KB block",
+                          static_cast<unsigned long long>(pool.block_size / 1024));
+        return -1;
+    }
+
+    if (pool.host_visible) {
+        void* data = nullptr;
+        if (vkMapMemory(m_device, block.memory, 0, pool.block_size, 0, &data) != VK_SUCCESS) {
+            vkFreeMemory(m_device, block.memory, nullptr);
+            return -1;
+        }
+        block.mapped = static_cast<uint8_t*>(data);
+    }
+
+    block.free_lists.resize(pool.max_order + 1);
+    block.free_lists[pool.max_order].insert(0);
+
+    for (size_t i = 0; i < pool.blocks.size(); ++i) {
+        if (pool.blocks[i].memory == VK_NULL_HANDLE) {
+            pool.blocks[i] = std::move(block);
+            return static_cast<int>(i);
+        }
+    }
+
+    pool.blocks.push_back(std::move(block));
+    return static_cast<int>(pool.blocks.size() - 1);
+}
+
+void MemoryHeap::ReleaseBlock(Block& block)
+{
+    if (block.memory == VK_NULL_HANDLE) return;
+
+    if (block.mapped) {
+        vkUnmapMemory(m_device, block.memory);
+    }
+    vkFreeMemory(m_device, block.memory, nullptr);
+    block = Block{};
+}
+
+bool MemoryHeap::AllocateFromBlock(Pool& pool, uint32_t block_index, uint32_t order,
+                                   MemoryAllocation& allocation)
+{
+    Block& block = pool.blocks[block_index];
+
+    // Smallest free buddy that is big enough
+    uint32_t found = order;
+    while (found <= pool.max_order && block.free_lists[found].empty()) {
+        ++found;
+    }
+    if (found > pool.max_order) {
+        return false;
+    }
+
+    VkDeviceSize offset = *block.free_lists[found].begin();
+    block.free_lists[found].erase(block.free_lists[found].begin());
+
+    // Split down to the requested order, releasing the upper halves
+    while (found > order) {
+        --found;
+        block.free_lists[found].insert(offset + OrderSize(found));
+    }
+
+    block.used += OrderSize(order);
+
+    allocation.memory = block.memory;
+    allocation.offset = offset;
+    allocation.size = OrderSize(order);
+    allocation.mapped = block.mapped ? block.mapped + offset : nullptr;
+    allocation.block = block_index;
+    allocation.order = order;
+    return true;
+}
+
+bool MemoryHeap::AllocateDedicated(VkDeviceSize size, uint32_t memory_type, MemoryAllocation& allocation)
+{
+    VkMemoryAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = size;
+    alloc_info.memoryTypeIndex = memory_type;
+
+    allocation = MemoryAllocation{};
+    if (vkAllocateMemory(m_device, &alloc_info, nullptr, &allocation.memory) != VK_SUCCESS) {
+        return false;
+    }
+
+    if (m_properties.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        void* data = nullptr;
+        if (vkMapMemory(m_device, allocation.memory, 0, size, 0, &data) != VK_SUCCESS) {
+            vkFreeMemory(m_device, allocation.memory, nullptr);
+            allocation.memory = VK_NULL_HANDLE;
+            return false;
+        }
+        allocation.mapped = static_cast<uint8_t*>(data);
+    }
+
+    allocation.size = size;
+    allocation.pool = -1;
+    m_dedicated.push_back({allocation.memory, allocation.mapped != nullptr});
+    m_dedicated_bytes += size;
+    return true;
+}
+
+void MemoryHeap::ReleaseDedicated(const Dedicated& dedicated)
+{
+    if (dedicated.mapped) {
+        vkUnmapMemory(m_device, dedicated.memory);
+    }
+    vkFreeMemory(m_device, dedicated.memory, nullptr);
+}
+
+VkDeviceSize MemoryHeap::LargestFree(const Block& block, const Pool& pool)
+{
+    for (uint32_t order = pool.max_order + 1; order-- > 0;) {
+        if (!block.free_lists[order].empty()) {
+            return OrderSize(order);
+        }
+    }
+    return 0;
+}
+
+} // namespace Tatoosh
@@ -0,0 +1,135 @@
+/*
+ * Tatoosh - UI Device Memory Heap
+ *
+ * Sub-allocates Vulkan device memory for the UI renderer. Large blocks are
+ * split with a buddy allocator, with one pool per memory type and resource
+ * kind (buffers and images never share a block, which sidesteps
+ * bufferImageGranularity). Host-visible blocks stay persistently mapped.
+ */
+
+#ifndef TATOOSH_MEMORY_HEAP_H
+#define TATOOSH_MEMORY_HEAP_H
+
+#include <vulkan/vulkan.h>
+#include <set>
+#include <vector>
+
+namespace Tatoosh {
+
+enum class MemoryKind {
+    Buffer,
+    Image
+};
+
+// A range of device memory handed out by the heap
+struct MemoryAllocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;        // Bytes reserved (power of two for pooled allocations)
+    VkDeviceSize requested = 0;   // Bytes the caller asked for
+    uint8_t* mapped = nullptr;    // Non-null for host-visible memory
+    int pool = -1;                // -1 for dedicated allocations
+    uint32_t block = 0;
+    uint32_t order = 0;
+};
+
+// Usage counters for one pool
+struct MemoryPoolStats {
+    uint32_t memory_type;
+    MemoryKind kind;
+    bool host_visible;
+    uint32_t block_count;
+    uint32_t allocation_count;
+    VkDeviceSize reserved_bytes;   // Device memory held by blocks
+    VkDeviceSize used_bytes;       // Bytes handed out, after rounding
+    VkDeviceSize requested_bytes;  // Bytes asked for, before rounding
+    VkDeviceSize largest_free;     // Largest single allocation that would still fit
+};
+
+// Totals across all pools plus dedicated allocations
+struct MemoryHeapStats {
+    uint32_t block_count;
+    uint32_t allocation_count;
+    uint32_t dedicated_count;
+    VkDeviceSize reserved_bytes;
+    VkDeviceSize used_bytes;
+    VkDeviceSize requested_bytes;
+    VkDeviceSize dedicated_bytes;
+    VkDeviceSize largest_free;
+    float internal_fragmentation;  // Share of used bytes lost to rounding
+    float external_fragmentation;  // 1 - largest_free / free bytes
+};
+
+class MemoryHeap {
+public:
+    MemoryHeap();
+    ~MemoryHeap();
+
+    bool Initialize(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties);
+    void Shutdown();
+
+    // Allocate memory matching the requirements. Returns false if no memory
+    // type with the requested properties could satisfy it.
+    bool Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+                  MemoryKind kind, MemoryAllocation& allocation);
+
+    // Return an allocation to its pool. Resets the allocation.
+    void Free(MemoryAllocation& allocation);
+
+    // Usage reporting
+    MemoryHeapStats GetStats() const;
+    std::vector<MemoryPoolStats> GetPoolStats() const;
+
+private:
+    // Smallest buddy; everything below is rounded up to this
+    static constexpr VkDeviceSize MIN_ALLOCATION = 256;
+    static constexpr VkDeviceSize DEVICE_BLOCK_SIZE = 32 * 1024 * 1024;
+    static constexpr VkDeviceSize HOST_BLOCK_SIZE = 16 * 1024 * 1024;
+
+    struct Block {
+        VkDeviceMemory memory;
+        uint8_t* mapped;
+        VkDeviceSize used;
+        std::vector<std::set<VkDeviceSize>> free_lists;  // Free offsets, indexed by order
+    };
+
+    struct Pool {
+        uint32_t memory_type;
+        MemoryKind kind;
+        bool host_visible;
+        VkDeviceSize block_size;
+        uint32_t max_order;
+        uint32_t allocation_count;
+        VkDeviceSize requested_bytes;
+        std::vector<Block> blocks;  // Released blocks keep their slot with a null memory handle
+    };
+
+    // Outstanding dedicated allocation, so Shutdown can free any left over
+    struct Dedicated {
+        VkDeviceMemory memory;
+        bool mapped;
+    };
+
+    uint32_t FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
+    int FindOrCreatePool(uint32_t memory_type, MemoryKind kind);
+    int CreateBlock(Pool& pool);
+    void ReleaseBlock(Block& block);
+    bool AllocateFromBlock(Pool& pool, uint32_t block_index, uint32_t order,
+                           MemoryAllocation& allocation);
+    bool AllocateDedicated(VkDeviceSize size, uint32_t memory_type, MemoryAllocation& allocation);
+    void ReleaseDedicated(const Dedicated& dedicated);
+
+    static VkDeviceSize OrderSize(uint32_t order) { return MIN_ALLOCATION << order; }
+    static VkDeviceSize LargestFree(const Block& block, const Pool& pool);
+
+    VkDevice m_device;
+    VkPhysicalDeviceMemoryProperties m_properties;
+    std::vector<Pool> m_pools;
+
+    std::vector<Dedicated> m_dedicated;
+    VkDeviceSize m_dedicated_bytes;
+};
+
+} // namespace Tatoosh
+
+#endif // TATOOSH_MEMORY_HEAP_H
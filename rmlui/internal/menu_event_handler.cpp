@@ -9,6 +9,9 @@
 #include "quake_command_executor.h"
 
 #include <cctype>
+#include <cstring>
+#include <iterator>
+#include <unordered_set>
 
 // Forward-declare UI_* and engine functions with extern "C" linkage instead of
 // including ui_manager.h.  menu_event_handler is compiled as part of the same
@@ -94,6 +97,56 @@ std::vector<std::string> SplitActions(const std::string& action)
     return parts;
 }
 
+enum class ArgKind {
+    None,
+    Text,
+    TextAndNumber
+};
+
+struct ActionSpec {
+    const char* name;
+    MenuOp op;
+    ArgKind args;
+};
+
+// Looked up only while compiling
+const ActionSpec ACTION_SPECS[] = {
+    {"navigate",        MenuOp::Navigate,       ArgKind::Text},
+    {"command",         MenuOp::Command,        ArgKind::Text},
+    {"cvar_changed",    MenuOp::CvarChanged,    ArgKind::Text},
+    {"cycle_cvar",      MenuOp::CycleCvar,      ArgKind::TextAndNumber},
+    {"apply_settings",  MenuOp::ApplySettings,  ArgKind::None},
+    {"revert_settings", MenuOp::RevertSettings, ArgKind::None},
+    {"close",           MenuOp::Close,          ArgKind::None},
+    {"close_all",       MenuOp::CloseAll,       ArgKind::None},
+    {"quit",            MenuOp::Quit,           ArgKind::None},
+    {"new_game",        MenuOp::NewGame,        ArgKind::None},
+    {"load_game",       MenuOp::LoadGame,       ArgKind::Text},
+    {"save_game",       MenuOp::SaveGame,       ArgKind::Text},
+    {"bind_key",        MenuOp::BindKey,        ArgKind::Text},
+    {"main_menu",       MenuOp::MainMenu,       ArgKind::None},
+};
+
+const ActionSpec* FindActionSpec(const std::string& name)
+{
+    for (const ActionSpec& spec : ACTION_SPECS) {
+        if (name == spec.name) return &spec;
+    }
+    return nullptr;
+}
+
+// Attributes holding actions, nearest first per event
+const Rml::String ATTR_DATA_EVENT_CLICK = "data-event-click";
+const Rml::String ATTR_ONCLICK = "onclick";
+const Rml::String ATTR_DATA_ACTION = "data-action";
+const Rml::String ATTR_DATA_EVENT_CHANGE = "data-event-change";
+const Rml::String ATTR_ONCHANGE = "onchange";
+const Rml::String BOUND_FLAG = "data-menu-event-handler-bound";
+
+// Listeners RegisterWithDocument attached and their elements have not yet
+// detached. Each removes itself in OnDetach; Shutdown frees the rest.
+std::unordered_set<ActionEventListener*> s_listeners;
+
 } // namespace
 
 // Static member definitions
@@ -139,10 +192,9 @@ bool MenuEventHandler::Initialize(Rml::Context* context)
     s_context = context;
 
     // NOTE: We intentionally do NOT register a custom event listener instancer here.
-    // RmlUI automatically attaches listeners for any "on*" attributes (onclick, onchange, etc.)
-    // via the global EventListenerInstancer. If we also attach our document-level listeners,
-    // actions will fire twice (once via the instancer, once via MenuEventHandler::ProcessEvent),
-    // which causes duplicate menu pushes and double-back behavior.
+    // RegisterWithDocument already attaches a compiled listener for every onclick/onchange
+    // attribute. An instancer would attach a second one per attribute, and actions would
+    // fire twice, which causes duplicate menu pushes and double-back behavior.
 
     s_initialized = true;
     Con_Printf("MenuEventHandler: Initialized\n");
@@ -153,6 +205,12 @@ void MenuEventHandler::Shutdown()
 {
     if (!s_initialized) return;
 
+    // Destroyed elements have detached and deleted their listeners already
+    if (!s_listeners.empty()) {
+        Con_Printf("MenuEventHandler: Releasing %zu action listeners\n", s_listeners.size());
+        ActionEventListener::ReleaseAll();
+    }
+
     s_context = nullptr;
     s_key_callback = nullptr;
     s_capturing_key = false;
@@ -166,20 +224,49 @@ void MenuEventHandler::RegisterWithDocument(Rml::ElementDocument* document)
 {
     if (!document) return;
 
-    const Rml::String bound_flag = "data-menu-event-handler-bound";
-    if (document->HasAttribute(bound_flag)) {
+    if (document->HasAttribute(BOUND_FLAG)) {
         return;
     }
 
-    document->AddEventListener(Rml::EventId::Click, &s_instance, true);
-    // Let data-value controllers update model values before we handle change events.
-    document->AddEventListener(Rml::EventId::Change, &s_instance, false);
-    document->SetAttribute(bound_flag, "1");
+    std::vector<Rml::Element*> pending{document};
+    while (!pending.empty()) {
+        Rml::Element* element = pending.back();
+        pending.pop_back();
+
+        AttachActions(element);
+
+        for (int i = 0; i < element->GetNumChildren(); ++i) {
+            pending.push_back(element->GetChild(i));
+        }
+    }
+
+    document->SetAttribute(BOUND_FLAG, "1");
+}
+
+void MenuEventHandler::AttachActions(Rml::Element* element)
+{
+    Rml::String click = element->GetAttribute<Rml::String>(ATTR_DATA_EVENT_CLICK, "");
+    if (click.empty()) click = element->GetAttribute<Rml::String>(ATTR_ONCLICK, "");
+    if (click.empty()) click = element->GetAttribute<Rml::String>(ATTR_DATA_ACTION, "");
+
+    Rml::String change = element->GetAttribute<Rml::String>(ATTR_DATA_EVENT_CHANGE, "");
+    if (change.empty()) change = element->GetAttribute<Rml::String>(ATTR_ONCHANGE, "");
+
+    if (!click.empty()) {
+        element->AddEventListener(Rml::EventId::Click,
+                                  ActionEventListener::Create(click));
+    }
+    // Added after the element's data-value controller, so the model value is
+    // updated before the action reads it
+    if (!change.empty()) {
+        element->AddEventListener(Rml::EventId::Change,
+                                  ActionEventListener::Create(change));
+    }
 }
 
 void MenuEventHandler::ProcessAction(const std::string& action)
 {
-    s_instance.ExecuteAction(action);
+    Run(Compile(action));
 }
 
 void MenuEventHandler::SetKeyCaptureCallback(KeyCaptureCallback callback)
@@ -219,121 +306,66 @@ void MenuEventHandler::OnKeyCaptured(int key, const char* key_name)
     s_key_action.clear();
 }
 
-void MenuEventHandler::ProcessEvent(Rml::Event& event)
+MenuProgram MenuEventHandler::Compile(const std::string& action)
 {
-    // Get the action from the element's attribute
-    Rml::Element* element = event.GetTargetElement();
-    if (!element) return;
+    MenuProgram program;
 
-    const Rml::String& event_type = event.GetType();
+    for (const std::string& part : SplitActions(action)) {
+        std::string name = TrimWhitespace(part.substr(0, part.find('(')));
 
-    Rml::String action;
-    if (!event_type.empty()) {
-        const Rml::String data_event_attr = "data-event-" + event_type;
-        for (Rml::Element* current = element; current != nullptr; current = current->GetParentNode()) {
-            action = current->GetAttribute<Rml::String>(data_event_attr, "");
-            if (!action.empty()) {
-                break;
-            }
+        const ActionSpec* spec = FindActionSpec(name);
+        if (!spec) {
+            Con_Printf("MenuEventHandler: Unknown action '%s'\n", name.c_str());
+            continue;
         }
-    }
 
-    if (action.empty() && !event_type.empty()) {
-        const Rml::String on_event_attr = "on" + event_type;
-        for (Rml::Element* current = element; current != nullptr; current = current->GetParentNode()) {
-            action = current->GetAttribute<Rml::String>(on_event_attr, "");
-            if (!action.empty()) {
-                break;
-            }
+        MenuInstruction instruction{spec->op, std::string(), 0};
+        if (spec->args == ArgKind::Text) {
+            instruction.arg = ExtractArg(part);
+        } else if (spec->args == ArgKind::TextAndNumber) {
+            auto args = ExtractTwoArgs(part);
+            instruction.arg = args.first;
+            instruction.number = args.second;
         }
-    }
 
-    if (action.empty()) {
-        for (Rml::Element* current = element; current != nullptr; current = current->GetParentNode()) {
-            action = current->GetAttribute<Rml::String>("data-action", "");
-            if (!action.empty()) {
-                break;
-            }
-            action = current->GetAttribute<Rml::String>("onclick", "");
-            if (!action.empty()) {
-                break;
-            }
+        // Bare menu names resolve to the menus directory
+        if (spec->op == MenuOp::Navigate && !instruction.arg.empty() &&
+            instruction.arg.find('/') == std::string::npos) {
+            instruction.arg = "ui/rml/menus/" + instruction.arg + ".rml";
         }
-    }
 
-    if (action.empty()) {
-        return;
+        program.push_back(std::move(instruction));
     }
 
-    Con_Printf("MenuEventHandler: event=%s action=%s target=%s id=%s\n",
-               event.GetType().c_str(),
-               action.c_str(),
-               element->GetTagName().c_str(),
-               element->GetId().c_str());
-
-    ExecuteAction(action.c_str());
+    return program;
 }
 
-void MenuEventHandler::ExecuteAction(const std::string& action)
+void MenuEventHandler::Run(const MenuProgram& program)
 {
-    if (action.empty()) return;
+    using Handler = void (*)(MenuEventHandler&, const MenuInstruction&);
 
-    if (action.find(';') != std::string::npos) {
-        auto actions = SplitActions(action);
-        if (actions.size() > 1) {
-            for (const auto& item : actions) {
-                ExecuteAction(item);
-            }
-            return;
-        }
-    }
+    // Indexed by MenuOp
+    static const Handler handlers[] = {
+        [](MenuEventHandler& h, const MenuInstruction& in) { h.ActionNavigate(in.arg); },
+        [](MenuEventHandler& h, const MenuInstruction& in) { h.ActionCommand(in.arg); },
+        [](MenuEventHandler& h, const MenuInstruction& in) { h.ActionCvarChanged(in.arg); },
+        [](MenuEventHandler& h, const MenuInstruction& in) { h.ActionCycleCvar(in.arg, in.number); },
+        [](MenuEventHandler& h, const MenuInstruction&) { h.ActionApplySettings(); },
+        [](MenuEventHandler& h, const MenuInstruction&) { h.ActionRevertSettings(); },
+        [](MenuEventHandler& h, const MenuInstruction&) { h.ActionClose(); },
+        [](MenuEventHandler& h, const MenuInstruction&) { h.ActionCloseAll(); },
+        [](MenuEventHandler& h, const MenuInstruction&) { h.ActionQuit(); },
+        [](MenuEventHandler& h, const MenuInstruction&) { h.ActionNewGame(); },
+        [](MenuEventHandler& h, const MenuInstruction& in) { h.ActionLoadGame(in.arg); },
+        [](MenuEventHandler& h, const MenuInstruction& in) { h.ActionSaveGame(in.arg); },
+        [](MenuEventHandler& h, const MenuInstruction& in) { h.ActionBindKey(in.arg); },
+        [](MenuEventHandler& h, const MenuInstruction&) { h.ActionMainMenu(); },
+    };
+    static_assert(std::size(handlers) == static_cast<size_t>(MenuOp::Count),
+                  "one handler per MenuOp");
 
-    // Parse action type
-    size_t paren_pos = action.find('(');
-    std::string func_name = (paren_pos != std::string::npos)
-        ? action.substr(0, paren_pos)
-        : action;
-
-    // Dispatch to handler
-    if (func_name == "navigate") {
-        ActionNavigate(ExtractArg(action));
-    }
-    else if (func_name == "command") {
-        ActionCommand(ExtractArg(action));
-    }
-    else if (func_name == "cvar_changed") {
-        ActionCvarChanged(ExtractArg(action));
-    }
-    else if (func_name == "cycle_cvar") {
-        auto args = ExtractTwoArgs(action);
-        ActionCycleCvar(args.first, args.second);
-    }
-    else if (func_name == "close") {
-        ActionClose();
-    }
-    else if (func_name == "close_all") {
-        ActionCloseAll();
-    }
-    else if (func_name == "quit") {
-        ActionQuit();
-    }
-    else if (func_name == "new_game") {
-        ActionNewGame();
-    }
-    else if (func_name == "load_game") {
-        ActionLoadGame(ExtractArg(action));
-    }
-    else if (func_name == "save_game") {
-        ActionSaveGame(ExtractArg(action));
-    }
-    else if (func_name == "bind_key") {
-        ActionBindKey(ExtractArg(action));
-    }
-    else if (func_name == "main_menu") {
-        ActionMainMenu();
-    }
-    else {
-        Con_Printf("MenuEventHandler: Unknown action '%s'\n", func_name.c_str());
+    for (const MenuInstruction& instruction : program) {
+        handlers[static_cast<size_t>(instruction.op)](s_instance, instruction);
     }
 }
 
@@ -417,14 +449,9 @@ void MenuEventHandler::ActionNavigate(const std::string& menu_path)
         return;
     }
 
-    // Build full path if needed
-    std::string full_path = menu_path;
-    if (menu_path.find('/') == std::string::npos) {
-        full_path = "ui/rml/menus/" + menu_path + ".rml";
-    }
-
-    Con_Printf("MenuEventHandler: Navigating to '%s'\n", full_path.c_str());
-    UI_PushMenu(full_path.c_str());
+    // Already a full path: Compile resolves bare menu names
+    Con_Printf("MenuEventHandler: Navigating to '%s'\n", menu_path.c_str());
+    UI_PushMenu(menu_path.c_str());
 }
 
 void MenuEventHandler::ActionCommand(const std::string& command)
@@ -459,6 +486,23 @@ void MenuEventHandler::ActionCycleCvar(const std::string& ui_name, int delta)
     CvarBindingManager::CycleEnum(ui_name, delta);
 }
 
+void MenuEventHandler::ActionApplySettings()
+{
+    // Staged settings all rebuild the renderer; one restart covers them all
+    if (CvarBindingManager::ApplyStaged()) {
+        Con_Printf("MenuEventHandler: Applying settings\n");
+        GetExecutor()->Execute("vid_restart");
+    }
+}
+
+void MenuEventHandler::ActionRevertSettings()
+{
+    if (CvarBindingManager::HasStagedChanges()) {
+        Con_Printf("MenuEventHandler: Reverting unapplied settings\n");
+        CvarBindingManager::RevertStaged();
+    }
+}
+
 void MenuEventHandler::ActionClose()
 {
     Con_Printf("MenuEventHandler: Closing current menu\n");
@@ -575,29 +619,37 @@ void MenuEventHandler::ActionMainMenu()
 // ActionEventListener implementation
 void ActionEventListener::ProcessEvent(Rml::Event& event)
 {
-    MenuEventHandler::ProcessAction(m_action.c_str());
+    Rml::Element* target = event.GetTargetElement();
+    Con_Printf("MenuEventHandler: event=%s action=%s target=%s id=%s\n",
+               event.GetType().c_str(),
+               m_action.c_str(),
+               target ? target->GetTagName().c_str() : "",
+               target ? target->GetId().c_str() : "");
+
+    // Stopped first: the program may close the document
+    event.StopPropagation();
+    MenuEventHandler::Run(m_program);
 }
 
 void ActionEventListener::OnDetach(Rml::Element* element)
 {
-    // Listener will be cleaned up by MenuEventInstancer
+    s_listeners.erase(this);
+    delete this;
 }
 
-// MenuEventInstancer implementation
-Rml::EventListener* MenuEventInstancer::InstanceEventListener(const Rml::String& value,
-                                                               Rml::Element* element)
+ActionEventListener* ActionEventListener::Create(const Rml::String& action)
 {
-    // Create a new listener and store it - we must manage the lifetime ourselves
-    // RmlUI does NOT take ownership of the returned listener
-    auto listener = std::make_unique<ActionEventListener>(value);
-    ActionEventListener* ptr = listener.get();
-    m_listeners.push_back(std::move(listener));
-    return ptr;
+    ActionEventListener* listener = new ActionEventListener(action);
+    s_listeners.insert(listener);
+    return listener;
 }
 
-void MenuEventInstancer::ReleaseAllListeners()
+void ActionEventListener::ReleaseAll()
 {
-    m_listeners.clear();
+    for (ActionEventListener* listener : s_listeners) {
+        delete listener;
+    }
+    s_listeners.clear();
 }
 
 } // namespace Tatoosh
@@ -2,14 +2,18 @@
  * Tatoosh - Menu Event Handler
  *
  * Handles events from RmlUI menu documents and executes Quake commands.
- * Provides a custom event listener that intercepts onclick/onchange events
- * and parses action strings.
+ * When a document is registered, the action string of each element's
+ * onclick/onchange attribute is compiled once into a MenuProgram, held by a
+ * listener on that element. An event runs the program through a table of
+ * handlers indexed by op, with arguments already extracted.
  *
  * Supported actions (use in RML onclick/data-event-click attributes):
  *   navigate('menu_name')       - Push a menu document onto the stack
  *   command('console_cmd')      - Execute a Quake console command
  *   cvar_changed('ui_name')     - Sync UI value to its bound cvar
  *   cycle_cvar('ui_name', 1)    - Increment/decrement an enum cvar
+ *   apply_settings()            - Write staged settings, then vid_restart
+ *   revert_settings()           - Drop staged settings
  *   close()                     - Close current menu (pop from stack)
  *   close_all()                 - Close all menus and return to game
  *   quit()                      - Quit the game
@@ -17,15 +21,18 @@
  *   load_game('slot')           - Load saved game from slot
  *   save_game('slot')           - Save current game to slot
  *   bind_key('action')          - Enter key capture mode for binding
+ *   main_menu()                 - Disconnect and return to the main menu
+ *
+ * Several actions can be chained with ';'.
  */
 
 #ifndef TATOOSH_MENU_EVENT_HANDLER_H
 #define TATOOSH_MENU_EVENT_HANDLER_H
 
 #include <RmlUi/Core.h>
+#include <cstdint>
 #include <string>
 #include <functional>
-#include <memory>
 #include <vector>
 #include "../types/command_executor.h"
 
@@ -34,7 +41,36 @@ namespace Tatoosh {
 // Callback for key capture mode
 using KeyCaptureCallback = std::function<void(int key, const char* key_name)>;
 
-class MenuEventHandler : public Rml::EventListener {
+// Menu actions, in the order of MenuEventHandler's dispatch table
+enum class MenuOp : uint8_t {
+    Navigate,
+    Command,
+    CvarChanged,
+    CycleCvar,
+    ApplySettings,
+    RevertSettings,
+    Close,
+    CloseAll,
+    Quit,
+    NewGame,
+    LoadGame,
+    SaveGame,
+    BindKey,
+    MainMenu,
+    Count
+};
+
+// One action with its arguments already extracted
+struct MenuInstruction {
+    MenuOp op;
+    std::string arg;    // Menu path, command, ui name, slot or key action
+    int number = 0;     // cycle_cvar delta
+};
+
+// A compiled action string, e.g. "revert_settings(); close()"
+using MenuProgram = std::vector<MenuInstruction>;
+
+class MenuEventHandler {
 public:
     // Get singleton instance
     static MenuEventHandler& Instance();
@@ -48,13 +84,21 @@ public:
     // Initialize the event handler with RmlUI context
     static bool Initialize(Rml::Context* context);
 
-    // Shutdown and cleanup
+    // Shutdown and cleanup. Frees any action listeners still alive, so call
+    // it after the documents and the context are destroyed.
     static void Shutdown();
 
-    // Register event listener with a document
+    // Compile the actions of every element in the document and attach a
+    // listener holding each program. Elements added later are not covered.
     static void RegisterWithDocument(Rml::ElementDocument* document);
 
-    // Process an action string (can be called directly for testing)
+    // Parse an action string. Unknown actions are reported and left out.
+    static MenuProgram Compile(const std::string& action);
+
+    // Execute a compiled action
+    static void Run(const MenuProgram& program);
+
+    // Compile and run an action string (can be called directly for testing)
     static void ProcessAction(const std::string& action);
 
     // Set callback for key capture (for key binding menu)
@@ -69,21 +113,20 @@ public:
     // Called when a key is captured
     static void OnKeyCaptured(int key, const char* key_name);
 
-    // Rml::EventListener interface
-    void ProcessEvent(Rml::Event& event) override;
-
 private:
     MenuEventHandler() = default;
     ~MenuEventHandler() = default;
 
-    // Parse and execute action string
-    void ExecuteAction(const std::string& action);
+    // Attach listeners for the element's own action attributes
+    static void AttachActions(Rml::Element* element);
 
     // Action handlers
     void ActionNavigate(const std::string& menu_path);
     void ActionCommand(const std::string& command);
     void ActionCvarChanged(const std::string& ui_name);
     void ActionCycleCvar(const std::string& ui_name, int delta);
+    void ActionApplySettings();
+    void ActionRevertSettings();
     void ActionClose();
     void ActionCloseAll();
     void ActionQuit();
@@ -106,32 +149,32 @@ private:
     static ICommandExecutor* s_executor;  // Injected command executor
 };
 
-// Event listener that stores an action value and executes it when triggered
+// Event listener that compiles an action once and runs it when triggered.
+// The nearest element with an action handles the event; it does not
+// propagate to ancestors' actions.
+// Each listener is attached to one element for one event and deletes itself
+// when that element detaches it, i.e. when the element is destroyed.
 class ActionEventListener : public Rml::EventListener {
 public:
-    explicit ActionEventListener(const Rml::String& action) : m_action(action) {}
+    // Allocated with new; owned by the element it is attached to
+    static ActionEventListener* Create(const Rml::String& action);
+
+    // Delete listeners whose elements were never destroyed. Only safe once
+    // no element can detach them any more, i.e. after the context is gone.
+    static void ReleaseAll();
 
     void ProcessEvent(Rml::Event& event) override;
 
-    // Called when listener is detached - we can clean up here
+    // The element is done with the listener: delete it
     void OnDetach(Rml::Element* element) override;
 
 private:
-    Rml::String m_action;
-};
+    explicit ActionEventListener(const Rml::String& action)
+        : m_action(action), m_program(MenuEventHandler::Compile(action)) {}
+    ~ActionEventListener() override = default;
 
-// Event instancer to create ActionEventListener for inline event handlers
-// Stores created listeners to manage their lifetime (RmlUI does NOT take ownership)
-class MenuEventInstancer : public Rml::EventListenerInstancer {
-public:
-    Rml::EventListener* InstanceEventListener(const Rml::String& value,
-                                               Rml::Element* element) override;
-
-    // Clean up all listeners
-    void ReleaseAllListeners();
-
-private:
-    std::vector<std::unique_ptr<ActionEventListener>> m_listeners;
+    Rml::String m_action;     // Source text, for the log
+    MenuProgram m_program;
 };
 
 } // namespace Tatoosh
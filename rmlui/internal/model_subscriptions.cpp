@@ -0,0 +1,76 @@
+/*
+ * Tatoosh - Data Model Subscriptions Implementation
+ */
+
+#include "model_subscriptions.h"
+
+namespace Tatoosh {
+
+std::vector<ModelSubscriptions::Subscription> ModelSubscriptions::s_subscriptions;
+
+void ModelSubscriptions::Register(const char* model, CatchUpFunc catch_up)
+{
+    if (Subscription* existing = Find(model)) {
+        existing->catch_up = catch_up;
+        return;
+    }
+    s_subscriptions.push_back({model, catch_up, false, false});
+}
+
+void ModelSubscriptions::Unregister(const char* model)
+{
+    for (auto it = s_subscriptions.begin(); it != s_subscriptions.end(); ++it) {
+        if (it->model == model) {
+            s_subscriptions.erase(it);
+            return;
+        }
+    }
+}
+
+void ModelSubscriptions::Refresh(Rml::Context* context)
+{
+    // A handful of documents and models, so a flat scan beats any bookkeeping
+    // on show and hide
+    for (Subscription& subscription : s_subscriptions) {
+        subscription.seen = false;
+    }
+
+    int num_documents = context ? context->GetNumDocuments() : 0;
+    for (int i = 0; i < num_documents; ++i) {
+        Rml::ElementDocument* document = context->GetDocument(i);
+        if (!document || !document->IsVisible()) continue;
+
+        const Rml::Variant* attribute = document->GetAttribute("data-model");
+        if (!attribute) continue;
+
+        if (Subscription* subscription = Find(attribute->Get<Rml::String>().c_str())) {
+            subscription->seen = true;
+        }
+    }
+
+    for (Subscription& subscription : s_subscriptions) {
+        bool became_visible = subscription.seen && !subscription.visible;
+        subscription.visible = subscription.seen;
+        if (became_visible && subscription.catch_up) {
+            subscription.catch_up();
+        }
+    }
+}
+
+bool ModelSubscriptions::IsVisible(const char* model)
+{
+    const Subscription* subscription = Find(model);
+    return subscription && subscription->visible;
+}
+
+ModelSubscriptions::Subscription* ModelSubscriptions::Find(const char* model)
+{
+    for (Subscription& subscription : s_subscriptions) {
+        if (subscription.model == model) {
+            return &subscription;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace Tatoosh
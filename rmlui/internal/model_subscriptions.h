@@ -0,0 +1,51 @@
+/*
+ * Tatoosh - Data Model Subscriptions
+ *
+ * Tracks which data models are bound by a visible document, so per-frame
+ * sync and dirty work can be skipped for models nobody is displaying.
+ * A document subscribes through the data-model attribute on its body.
+ */
+
+#ifndef TATOOSH_MODEL_SUBSCRIPTIONS_H
+#define TATOOSH_MODEL_SUBSCRIPTIONS_H
+
+#include <RmlUi/Core.h>
+#include <string>
+#include <vector>
+
+namespace Tatoosh {
+
+class ModelSubscriptions {
+public:
+    // Called when a model becomes visible again, to catch up on skipped syncs.
+    // Must not register or unregister models.
+    using CatchUpFunc = void (*)();
+
+    // Track a model by name. Unregistered models always report not visible.
+    static void Register(const char* model, CatchUpFunc catch_up);
+    static void Unregister(const char* model);
+
+    // Rescan the documents of the context (null: nothing is visible).
+    // Cheap enough to call every frame. Runs the catch-up of each model that
+    // was hidden at the last refresh and is visible now.
+    static void Refresh(Rml::Context* context);
+
+    // True if a visible document bound the model at the last refresh
+    static bool IsVisible(const char* model);
+
+private:
+    struct Subscription {
+        std::string model;
+        CatchUpFunc catch_up;
+        bool visible;
+        bool seen;        // Scratch for Refresh
+    };
+
+    static Subscription* Find(const char* model);
+
+    static std::vector<Subscription> s_subscriptions;
+};
+
+} // namespace Tatoosh
+
+#endif // TATOOSH_MODEL_SUBSCRIPTIONS_H
@@ -6,11 +6,14 @@
  */
 
 #include "notification_model.h"
+#include "cvar_handle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 extern "C" {
     void Con_Printf(const char* fmt, ...);
-    double Cvar_VariableValue(const char* var_name);
-    extern double realtime;
 }
 
 namespace Tatoosh {
@@ -19,45 +22,33 @@ namespace Tatoosh {
 NotificationState NotificationModel::s_state;
 Rml::DataModelHandle NotificationModel::s_model_handle;
 bool NotificationModel::s_initialized = false;
-bool NotificationModel::s_centerprint_was_visible = false;
-bool NotificationModel::s_notify_was_visible[NUM_NOTIFY_LINES] = {};
+bool NotificationModel::s_centerprint_visible = false;
+double NotificationModel::s_next_expiry = std::numeric_limits<double>::infinity();
+double NotificationModel::s_scheduled_notifytime = 0.0;
 
-// Bound strings — RmlUI binds to these pointers
+// Bound values — RmlUI binds to these pointers
 static Rml::String s_centerprint_text;
-static Rml::String s_notify_text[NUM_NOTIFY_LINES];
+static std::vector<Rml::String> s_notify_view;
+
+// Variable names, built once
+static const Rml::String VAR_CENTERPRINT = "centerprint";
+static const Rml::String VAR_CENTERPRINT_VISIBLE = "centerprint_visible";
+static const Rml::String VAR_NOTIFY = "notify";
+
+static CvarHandle s_con_notifytime("con_notifytime");
+static CvarHandle s_scr_centertime("scr_centertime");
+static CvarHandle s_ui_notifylines("ui_notifylines");
+static CvarHandle s_ui_notifyrate("ui_notifyrate");
 
 void NotificationModel::RegisterBindings(Rml::DataModelConstructor& constructor)
 {
-    // Centerprint text
-    constructor.Bind("centerprint", &s_centerprint_text);
-
-    // Centerprint visibility (computed)
-    constructor.BindFunc("centerprint_visible",
-        [](Rml::Variant& variant) {
-            variant = !s_state.centerprint.empty() &&
-                      (realtime < s_state.centerprint_expire);
-        });
-
-    // Notify lines — 4 fixed slots
-    constructor.Bind("notify_0", &s_notify_text[0]);
-    constructor.Bind("notify_1", &s_notify_text[1]);
-    constructor.Bind("notify_2", &s_notify_text[2]);
-    constructor.Bind("notify_3", &s_notify_text[3]);
-
-    // Notify visibility (computed per-slot)
-    for (int i = 0; i < NUM_NOTIFY_LINES; i++) {
-        Rml::String name = "notify_" + std::to_string(i) + "_visible";
-        int slot = i;
-        constructor.BindFunc(name,
-            [slot](Rml::Variant& variant) {
-                double notifytime = Cvar_VariableValue("con_notifytime");
-                if (notifytime <= 0.0) notifytime = 3.0;
-                const auto& line = s_state.notify[slot];
-                variant = !line.text.empty() &&
-                          line.time > 0.0 &&
-                          (realtime - line.time) < notifytime;
-            });
-    }
+    // Centerprint text and visibility
+    constructor.Bind(VAR_CENTERPRINT, &s_centerprint_text);
+    constructor.Bind(VAR_CENTERPRINT_VISIBLE, &s_centerprint_visible);
+
+    // Notify lines, oldest first: data-for="line : notify"
+    constructor.RegisterArray<std::vector<Rml::String>>();
+    constructor.Bind(VAR_NOTIFY, &s_notify_view);
 
     s_initialized = true;
     Con_Printf("NotificationModel: Bindings registered\n");
@@ -74,15 +65,12 @@ void NotificationModel::Shutdown()
 
     s_state = NotificationState{};
     s_centerprint_text.clear();
-    for (int i = 0; i < NUM_NOTIFY_LINES; i++) {
-        s_notify_text[i].clear();
-    }
+    s_notify_view.clear();
     s_model_handle = Rml::DataModelHandle();
     s_initialized = false;
-    s_centerprint_was_visible = false;
-    for (int i = 0; i < NUM_NOTIFY_LINES; i++) {
-        s_notify_was_visible[i] = false;
-    }
+    s_centerprint_visible = false;
+    s_next_expiry = std::numeric_limits<double>::infinity();
+    s_scheduled_notifytime = 0.0;
 
     Con_Printf("NotificationModel: Shutdown\n");
 }
@@ -91,83 +79,193 @@ void NotificationModel::Update(double real_time)
 {
     if (!s_initialized || !s_model_handle) return;
 
-    // Check centerprint visibility transition
-    bool cp_visible = !s_state.centerprint.empty() &&
-                      (real_time < s_state.centerprint_expire);
+    bool has_pending = s_state.has_pending_centerprint || !s_state.pending_notify.empty();
 
-    if (cp_visible != s_centerprint_was_visible) {
-        s_centerprint_text = cp_visible ? s_state.centerprint : "";
-        s_model_handle.DirtyVariable("centerprint");
-        s_model_handle.DirtyVariable("centerprint_visible");
-        s_centerprint_was_visible = cp_visible;
+    // Nothing printed and nothing can have expired yet. A changed
+    // con_notifytime moves every deadline, so it reschedules too.
+    if (!has_pending && real_time < s_next_expiry && NotifyTime() == s_scheduled_notifytime) return;
+
+    if (has_pending) {
+        FlushPending(real_time);
     }
 
-    // Check notify visibility transitions
-    double notifytime = Cvar_VariableValue("con_notifytime");
-    if (notifytime <= 0.0) notifytime = 3.0;
-
-    for (int i = 0; i < NUM_NOTIFY_LINES; i++) {
-        const auto& line = s_state.notify[i];
-        bool visible = !line.text.empty() &&
-                       line.time > 0.0 &&
-                       (real_time - line.time) < notifytime;
-
-        if (visible != s_notify_was_visible[i]) {
-            s_notify_text[i] = visible ? line.text : "";
-            s_model_handle.DirtyVariable("notify_" + std::to_string(i));
-            s_model_handle.DirtyVariable("notify_" + std::to_string(i) + "_visible");
-            s_notify_was_visible[i] = visible;
-        }
+    if (s_centerprint_visible && real_time >= s_state.centerprint_expire) {
+        s_centerprint_text.clear();
+        s_centerprint_visible = false;
+        s_model_handle.DirtyVariable(VAR_CENTERPRINT);
+        s_model_handle.DirtyVariable(VAR_CENTERPRINT_VISIBLE);
+    }
+
+    if (DropExpiredLines(real_time)) {
+        RebuildNotifyView();
     }
+
+    ScheduleNextExpiry();
 }
 
 void NotificationModel::CenterPrint(const char* text, double real_time)
 {
     if (!s_initialized || !text) return;
 
-    double centertime = Cvar_VariableValue("scr_centertime");
-    if (centertime <= 0.0) centertime = 2.0;
+    s_state.pending_centerprint = text;
+    s_state.pending_centerprint_time = real_time;
+    s_state.has_pending_centerprint = true;
+}
+
+void NotificationModel::NotifyPrint(const char* text, double real_time)
+{
+    if (!s_initialized || !text || !text[0]) return;
 
-    s_state.centerprint = text;
-    s_state.centerprint_start = real_time;
-    s_state.centerprint_expire = real_time + centertime;
+    // Strip trailing newline for display
+    size_t length = strlen(text);
+    while (length > 0 && (text[length - 1] == '\n' || text[length - 1] == '\r')) {
+        length--;
+    }
+    if (length == 0) return;
 
-    // Immediately update bound string and dirty
-    s_centerprint_text = text;
-    s_centerprint_was_visible = true;
+    auto& pending = s_state.pending_notify;
 
-    if (s_model_handle) {
-        s_model_handle.DirtyVariable("centerprint");
-        s_model_handle.DirtyVariable("centerprint_visible");
+    // A repeat of the newest line only bumps its counter. A showing line that
+    // has expired (Update doesn't run while the HUD is hidden) is gone already.
+    const NotifyLine* newest = nullptr;
+    if (!pending.empty()) {
+        newest = &pending.back();
+    } else if (!s_state.notify.empty() && real_time - s_state.notify.back().time < NotifyTime()) {
+        newest = &s_state.notify.back();
+    }
+    bool repeat = newest && newest->text.compare(0, std::string::npos, text, length) == 0;
+
+    if (repeat && !pending.empty()) {
+        pending.back().count++;
+        pending.back().time = real_time;
+        return;
+    }
+
+    // Over the rate the line is left to the console alone. Not logged: a
+    // log line would come straight back here as another print.
+    if (!repeat && !TakeRateToken(real_time)) return;
+
+    // A repeat of a line already showing is queued with the same text;
+    // FlushPending folds it into that line
+    NotifyLine line;
+    line.text.assign(text, length);
+    line.time = real_time;
+    pending.push_back(std::move(line));
+
+    if (pending.size() > static_cast<size_t>(MAX_NOTIFY_LINES)) {
+        pending.pop_front();
     }
 }
 
-void NotificationModel::NotifyPrint(const char* text, double real_time)
+void NotificationModel::FlushPending(double real_time)
 {
-    if (!s_initialized || !text || !text[0]) return;
+    if (s_state.has_pending_centerprint) {
+        double centertime = s_scr_centertime.GetFloat();
+        if (centertime <= 0.0) centertime = 2.0;
+
+        double start = s_state.pending_centerprint_time;
+        s_state.centerprint_start = start;
+        s_state.centerprint_expire = start + centertime;
+
+        // Re-centerprinting the same text only extends it
+        bool visible = !s_state.pending_centerprint.empty();
+        if (s_state.pending_centerprint != s_state.centerprint || visible != s_centerprint_visible) {
+            s_state.centerprint.swap(s_state.pending_centerprint);
+            s_centerprint_text = s_state.centerprint;
+            s_centerprint_visible = visible;
+            s_model_handle.DirtyVariable(VAR_CENTERPRINT);
+            s_model_handle.DirtyVariable(VAR_CENTERPRINT_VISIBLE);
+        }
 
-    // Write into ring buffer at the head position
-    int slot = s_state.notify_head;
-    s_state.notify[slot].text = text;
-    s_state.notify[slot].time = real_time;
+        s_state.pending_centerprint.clear();
+        s_state.has_pending_centerprint = false;
+    }
 
-    // Strip trailing newline for display
-    auto& str = s_state.notify[slot].text;
-    while (!str.empty() && (str.back() == '\n' || str.back() == '\r')) {
-        str.pop_back();
+    if (!s_state.pending_notify.empty()) {
+        // An expired line must not take a repeat and reappear
+        DropExpiredLines(real_time);
+
+        for (NotifyLine& line : s_state.pending_notify) {
+            if (!s_state.notify.empty() && s_state.notify.back().text == line.text) {
+                s_state.notify.back().count += line.count;
+                s_state.notify.back().time = line.time;
+            } else {
+                s_state.notify.push_back(std::move(line));
+            }
+        }
+        s_state.pending_notify.clear();
+
+        // Oldest lines scroll off once the configured count is exceeded
+        int max_lines = static_cast<int>(s_ui_notifylines.GetFloat());
+        if (max_lines <= 0) max_lines = DEFAULT_NOTIFY_LINES;
+        max_lines = std::min(max_lines, MAX_NOTIFY_LINES);
+        while (s_state.notify.size() > static_cast<size_t>(max_lines)) {
+            s_state.notify.pop_front();
+        }
+
+        RebuildNotifyView();
     }
+}
+
+double NotificationModel::NotifyTime()
+{
+    double notifytime = s_con_notifytime.GetFloat();
+    return notifytime > 0.0 ? notifytime : 3.0;
+}
+
+bool NotificationModel::DropExpiredLines(double real_time)
+{
+    double notifytime = NotifyTime();
+    auto expired = [&](const NotifyLine& line) { return real_time - line.time >= notifytime; };
+
+    auto end = std::remove_if(s_state.notify.begin(), s_state.notify.end(), expired);
+    if (end == s_state.notify.end()) return false;
+
+    s_state.notify.erase(end, s_state.notify.end());
+    return true;
+}
+
+bool NotificationModel::TakeRateToken(double real_time)
+{
+    double rate = s_ui_notifyrate.GetFloat();
+    if (rate <= 0.0) return true;
+
+    // Bucket holds one second of lines, so a short burst still gets through
+    s_state.rate_tokens = std::min(rate, s_state.rate_tokens + (real_time - s_state.rate_time) * rate);
+    s_state.rate_time = real_time;
 
-    // Update bound string and dirty
-    s_notify_text[slot] = s_state.notify[slot].text;
-    s_notify_was_visible[slot] = true;
+    if (s_state.rate_tokens < 1.0) return false;
+    s_state.rate_tokens -= 1.0;
+    return true;
+}
+
+void NotificationModel::RebuildNotifyView()
+{
+    s_notify_view.resize(s_state.notify.size());
+    for (size_t i = 0; i < s_state.notify.size(); i++) {
+        const NotifyLine& line = s_state.notify[i];
+        s_notify_view[i] = line.text;
+        if (line.count > 1) {
+            s_notify_view[i] += " x" + std::to_string(line.count);
+        }
+    }
 
     if (s_model_handle) {
-        s_model_handle.DirtyVariable("notify_" + std::to_string(slot));
-        s_model_handle.DirtyVariable("notify_" + std::to_string(slot) + "_visible");
+        s_model_handle.DirtyVariable(VAR_NOTIFY);
     }
+}
 
-    // Advance ring buffer
-    s_state.notify_head = (slot + 1) % NUM_NOTIFY_LINES;
+void NotificationModel::ScheduleNextExpiry()
+{
+    s_next_expiry = std::numeric_limits<double>::infinity();
+    if (s_centerprint_visible) {
+        s_next_expiry = s_state.centerprint_expire;
+    }
+
+    s_scheduled_notifytime = NotifyTime();
+    for (const NotifyLine& line : s_state.notify) {
+        s_next_expiry = std::min(s_next_expiry, line.time + s_scheduled_notifytime);
+    }
 }
 
 } // namespace Tatoosh
@@ -3,6 +3,15 @@
  *
  * Manages centerprint and notify messages for the HUD.
  * Bindings are registered on the "game" data model alongside GameDataModel.
+ *
+ * Notify lines are bound as the "notify" array, oldest first, holding up to
+ * ui_notifylines entries. Expiry is scheduled: Update returns immediately
+ * until the earliest centerprint or notify deadline has passed.
+ *
+ * Prints are queued and applied once per frame, so a flood of prints costs
+ * one rebuild of the visible lines. Identical consecutive prints collapse
+ * into one line with an "xN" counter, and ui_notifyrate caps new lines per
+ * second.
  */
 
 #ifndef TATOOSH_NOTIFICATION_MODEL_H
@@ -25,25 +34,42 @@ public:
     // Shutdown and cleanup
     static void Shutdown();
 
-    // Update expiration state. Call each frame from UI_Update.
-    // game_time: cl.time from the engine (for centerprint expiry)
-    // real_time: realtime from the engine (for notify expiry)
+    // Expire messages whose deadline has passed. Call each frame from
+    // UI_Update; costs a compare and a cvar read until the next deadline.
+    // real_time: realtime from the engine
     static void Update(double real_time);
 
-    // Push a centerprint message
+    // Queue a centerprint message; the last one in a frame wins
     static void CenterPrint(const char* text, double real_time);
 
-    // Push a notify message (console line)
+    // Queue a notify message (console line)
     static void NotifyPrint(const char* text, double real_time);
 
 private:
+    // Apply the prints queued since the last update
+    static void FlushPending(double real_time);
+
+    // Current con_notifytime, or Quake's default if unset
+    static double NotifyTime();
+
+    // Remove every notify line older than con_notifytime; true if any went
+    static bool DropExpiredLines(double real_time);
+
+    // True if the rate limit lets one more distinct line through
+    static bool TakeRateToken(double real_time);
+
+    // Copy the visible lines into the bound array and dirty it
+    static void RebuildNotifyView();
+
+    // Earliest pending deadline, or infinity if nothing is showing
+    static void ScheduleNextExpiry();
+
     static NotificationState s_state;
     static Rml::DataModelHandle s_model_handle;
     static bool s_initialized;
-
-    // Cached visibility state to avoid dirtying every frame
-    static bool s_centerprint_was_visible;
-    static bool s_notify_was_visible[NUM_NOTIFY_LINES];
+    static bool s_centerprint_visible;
+    static double s_next_expiry;
+    static double s_scheduled_notifytime;  // con_notifytime s_next_expiry was computed with
 };
 
 } // namespace Tatoosh
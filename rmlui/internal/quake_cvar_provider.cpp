@@ -54,4 +54,20 @@ bool QuakeCvarProvider::Exists(const std::string& name) const
     return Cvar_FindVar(name.c_str()) != nullptr;
 }
 
+CvarRef QuakeCvarProvider::Find(const char* name) const
+{
+    return CvarRef{Cvar_FindVar(name)};
+}
+
+float QuakeCvarProvider::GetFloat(CvarRef cvar) const
+{
+    return static_cast<const cvar_t*>(cvar.ptr)->value;
+}
+
+const char* QuakeCvarProvider::GetString(CvarRef cvar) const
+{
+    const char* str = static_cast<const cvar_t*>(cvar.ptr)->string;
+    return str ? str : "";
+}
+
 } // namespace Tatoosh
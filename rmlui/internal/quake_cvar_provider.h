@@ -23,6 +23,10 @@ public:
     void SetString(const std::string& name, const std::string& value) override;
     bool Exists(const std::string& name) const override;
 
+    CvarRef Find(const char* name) const override;
+    float GetFloat(CvarRef cvar) const override;
+    const char* GetString(CvarRef cvar) const override;
+
 private:
     QuakeCvarProvider() = default;
 };
@@ -8,8 +8,10 @@
 #include <RmlUi/Core/Core.h>
 #include <RmlUi/Core/FileInterface.h>
 #include <RmlUi/Core/Log.h>
+#include <algorithm>
 #include <cstring>
 #include <cmath>
+#include <numeric>
 
 // stb_image for texture loading (implementation is in engine/Quake/image.c)
 // Use extern "C" because the implementation is compiled as C code
@@ -23,6 +25,54 @@ extern "C" {
 
 namespace Tatoosh {
 
+// Arena blocks start on a boundary that is a multiple of both the vertex stride
+// and the uint32 index alignment, so offsets stay valid for either use.
+static constexpr VkDeviceSize ARENA_ALIGNMENT = std::lcm(sizeof(Rml::Vertex), size_t(16));
+
+static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// FNV-1a, used to fingerprint the frame's draw stream
+static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+// Rect helpers for dirty regions; an empty rect never overlaps anything
+static bool RectsOverlap(const VkRect2D& a, const VkRect2D& b)
+{
+    return a.extent.width > 0 && a.extent.height > 0 && b.extent.width > 0 && b.extent.height > 0 &&
+           a.offset.x < b.offset.x + static_cast<int32_t>(b.extent.width) &&
+           b.offset.x < a.offset.x + static_cast<int32_t>(a.extent.width) &&
+           a.offset.y < b.offset.y + static_cast<int32_t>(b.extent.height) &&
+           b.offset.y < a.offset.y + static_cast<int32_t>(a.extent.height);
+}
+
+static VkRect2D RectUnion(const VkRect2D& a, const VkRect2D& b)
+{
+    int32_t left = std::min(a.offset.x, b.offset.x);
+    int32_t top = std::min(a.offset.y, b.offset.y);
+    int32_t right = std::max(a.offset.x + static_cast<int32_t>(a.extent.width),
+                             b.offset.x + static_cast<int32_t>(b.extent.width));
+    int32_t bottom = std::max(a.offset.y + static_cast<int32_t>(a.extent.height),
+                              b.offset.y + static_cast<int32_t>(b.extent.height));
+    return {{left, top}, {static_cast<uint32_t>(right - left), static_cast<uint32_t>(bottom - top)}};
+}
+
+static VkRect2D RectIntersection(const VkRect2D& a, const VkRect2D& b)
+{
+    if (!RectsOverlap(a, b)) {
+        return {{a.offset.x, a.offset.y}, {0, 0}};
+    }
+    int32_t left = std::max(a.offset.x, b.offset.x);
+    int32_t top = std::max(a.offset.y, b.offset.y);
+    int32_t right = std::min(a.offset.x + static_cast<int32_t>(a.extent.width),
+                             b.offset.x + static_cast<int32_t>(b.extent.width));
+    int32_t bottom = std::min(a.offset.y + static_cast<int32_t>(a.extent.height),
+                              b.offset.y + static_cast<int32_t>(b.extent.height));
+    return {{left, top}, {static_cast<uint32_t>(right - left), static_cast<uint32_t>(bottom - top)}};
+}
+
 RenderInterface_VK::RenderInterface_VK()
     : m_config{}
     , m_current_cmd(VK_NULL_HANDLE)
@@ -31,6 +81,13 @@ RenderInterface_VK::RenderInterface_VK()
     , m_scissor_enabled(false)
     , m_scissor_rect{}
     , m_transform_enabled(false)
+    , m_bound{}
+    , m_frame_hash(FNV_OFFSET_BASIS)
+    , m_recorded_hash(0)
+    , m_in_frame(false)
+    , m_partial_frame(false)
+    , m_frame_stats{}
+    , m_last_frame_stats{}
     , m_pipeline_textured(VK_NULL_HANDLE)
     , m_pipeline_untextured(VK_NULL_HANDLE)
     , m_pipeline_layout(VK_NULL_HANDLE)
@@ -38,12 +95,28 @@ RenderInterface_VK::RenderInterface_VK()
     , m_texture_set_layout(VK_NULL_HANDLE)
     , m_sampler(VK_NULL_HANDLE)
     , m_white_texture(nullptr)
+    , m_placeholder_texture(nullptr)
+    , m_bindless(false)
+    , m_bindless_set(VK_NULL_HANDLE)
+    , m_next_texture_slot(0)
     , m_next_geometry_handle(1)
     , m_next_texture_handle(1)
+    , m_arena_chunk_cursor(0)
+    , m_recording_upload(-1)
+    , m_next_upload_serial(1)
+    , m_completed_upload_serial(0)
+    , m_upload_semaphore(VK_NULL_HANDLE)
+    , m_decode_stop(false)
     , m_initialized(false)
     , m_garbage_index(0)
+    , m_collect_count(0)
+    , m_recording_pool(VK_NULL_HANDLE)
+    , m_cached_recording(-1)
+    , m_cached_hash(0)
 {
     m_transform = Rml::Matrix4f::Identity();
+    m_projection = Rml::Matrix4f::Identity();
+    m_mvp = Rml::Matrix4f::Identity();
 }
 
 RenderInterface_VK::~RenderInterface_VK()
@@ -57,12 +130,17 @@ bool RenderInterface_VK::Initialize(const VulkanConfig& config)
 {
     m_config = config;
 
-    if (!CreateDescriptorSetLayout()) {
+    m_memory_heap.Initialize(m_config.device, m_config.memory_properties);
+
+    // Prefer one global texture array; fall back to a descriptor set per texture
+    m_bindless = m_config.descriptor_indexing && CreateBindlessDescriptors();
+
+    if (!m_bindless && !CreateDescriptorSetLayout()) {
         Rml::Log::Message(Rml::Log::LT_ERROR, "Failed to create descriptor set layout");
         return false;
     }
 
-    if (!CreateDescriptorPool()) {
+    if (!m_bindless && !CreateDescriptorPool()) {
         Rml::Log::Message(Rml::Log::LT_ERROR, "Failed to create descriptor pool");
         return false;
     }
@@ -84,6 +162,15 @@ bool RenderInterface_VK::Initialize(const VulkanConfig& config)
         m_white_texture = m_textures[white_handle];
     }
 
+    Rml::byte clear_pixel[] = {0, 0, 0, 0};
+    auto placeholder_handle = GenerateTexture(Rml::Span<const Rml::byte>(clear_pixel, 4), {1, 1});
+    if (placeholder_handle) {
+        m_placeholder_texture = m_textures[placeholder_handle];
+    }
+    FlushUploads();
+
+    StartDecodeWorkers();
+
     m_initialized = true;
     return true;
 }
@@ -92,12 +179,12 @@ void RenderInterface_VK::Shutdown()
 {
     if (!m_initialized) return;
 
+    StopDecodeWorkers();
+
     vkDeviceWaitIdle(m_config.device);
 
-    // Release all geometries
+    // Release all geometries (their arena blocks go away with the arena below)
     for (auto& pair : m_geometries) {
-        DestroyBuffer(pair.second->vertex_buffer, pair.second->vertex_memory);
-        DestroyBuffer(pair.second->index_buffer, pair.second->index_memory);
         delete pair.second;
     }
     m_geometries.clear();
@@ -109,12 +196,13 @@ void RenderInterface_VK::Shutdown()
     }
     m_textures.clear();
     m_white_texture = nullptr;
+    m_placeholder_texture = nullptr;
+    m_free_texture_slots.clear();
+    m_next_texture_slot = 0;
 
     // Clean up any pending garbage (safe since we called vkDeviceWaitIdle)
     for (int slot = 0; slot < GARBAGE_SLOTS; ++slot) {
         for (GeometryData* geometry : m_geometry_garbage[slot]) {
-            DestroyBuffer(geometry->vertex_buffer, geometry->vertex_memory);
-            DestroyBuffer(geometry->index_buffer, geometry->index_memory);
             delete geometry;
         }
         m_geometry_garbage[slot].clear();
@@ -126,7 +214,12 @@ void RenderInterface_VK::Shutdown()
         m_texture_garbage[slot].clear();
     }
 
+    EvictMergedBatches(true);
+    DestroyRecordings();
+    DestroyUploadContexts();
+    DestroyArena();
     DestroyPipelines();
+    m_memory_heap.Shutdown();
 
     m_initialized = false;
 }
@@ -153,6 +246,7 @@ void RenderInterface_VK::DestroyPipelines()
     if (m_descriptor_pool != VK_NULL_HANDLE) {
         vkDestroyDescriptorPool(m_config.device, m_descriptor_pool, nullptr);
         m_descriptor_pool = VK_NULL_HANDLE;
+        m_bindless_set = VK_NULL_HANDLE;
     }
     if (m_texture_set_layout != VK_NULL_HANDLE) {
         vkDestroyDescriptorSetLayout(m_config.device, m_texture_set_layout, nullptr);
@@ -188,6 +282,12 @@ bool RenderInterface_VK::Reinitialize(const VulkanConfig& config)
     // Update config with new render pass
     m_config = config;
 
+    // The recorded frame uses the old pipelines and render pass, and the
+    // engine's copy of the last UI image may be gone with it
+    m_cached_recording = -1;
+    m_recorded_hash = 0;
+    m_recorded_records.clear();
+
     // Recreate pipeline with new render pass
     if (!CreatePipeline()) {
         Rml::Log::Message(Rml::Log::LT_ERROR, "Failed to recreate pipeline");
@@ -200,109 +300,157 @@ bool RenderInterface_VK::Reinitialize(const VulkanConfig& config)
 
 void RenderInterface_VK::BeginFrame(VkCommandBuffer cmd, int width, int height)
 {
+    // cmd may be null: the frame is then only captured, and recorded into the
+    // command buffer handed to SetCommandBuffer before EndFrame (if any)
     m_current_cmd = cmd;
     m_viewport_width = width;
     m_viewport_height = height;
-
-    // Set viewport
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(width);
-    viewport.height = static_cast<float>(height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    if (m_config.cmd_set_viewport) {
-        m_config.cmd_set_viewport(cmd, 0, 1, &viewport);
-    } else {
-        vkCmdSetViewport(cmd, 0, 1, &viewport);
-    }
+    m_in_frame = true;
 
     // Reset scissor to full viewport
     m_scissor_rect = {{0, 0}, {static_cast<uint32_t>(width), static_cast<uint32_t>(height)}};
     m_scissor_enabled = false;
+
+    // Nothing of ours is bound on a fresh command buffer
+    m_bound = BoundState{};
+    m_draw_list.clear();
+    m_frame_transforms.clear();
+    m_frame_records.clear();
+    m_dirty_rects.clear();
+    m_partial_frame = false;
+    m_frame_stats = ui_render_stats_t{};
+
+    ResetFrameHash();
+
+    // Orthographic projection, shared by every draw this frame
+    float L = 0.0f;
+    float R = static_cast<float>(width);
+    float T = 0.0f;
+    float B = static_cast<float>(height);
+
+    m_projection = Rml::Matrix4f::FromRows(
+        {2.0f / (R - L), 0.0f, 0.0f, (R + L) / (L - R)},
+        {0.0f, 2.0f / (B - T), 0.0f, (T + B) / (T - B)},
+        {0.0f, 0.0f, -1.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f, 1.0f}
+    );
+    UpdateMvp();
+
+    // Queue uploads for images that finished decoding; they are flushed in EndFrame
+    ProcessDecodedTextures();
 }
 
 void RenderInterface_VK::EndFrame()
 {
+    FlushDraws();
     m_current_cmd = VK_NULL_HANDLE;
+    m_in_frame = false;
+    m_last_frame_stats = m_frame_stats;
+
+    // The engine submits its frame command buffer to the same queue after this,
+    // and the batch ends in a barrier into FRAGMENT_SHADER, so textures uploaded
+    // here can already be sampled by this frame. With upload_semaphore the
+    // engine's submit also waits on TakeUploadSemaphore().
+    FlushUploads();
+}
+
+VkSemaphore RenderInterface_VK::TakeUploadSemaphore()
+{
+    VkSemaphore semaphore = m_upload_semaphore;
+    m_upload_semaphore = VK_NULL_HANDLE;
+    return semaphore;
 }
 
 void RenderInterface_VK::CollectGarbage()
 {
+    // Release staging memory of upload batches that have finished, without waiting
+    RetireUploads();
+
     // Toggle to the other slot - resources queued there are from 2 frames ago
     // and are now safe to destroy (GPU fence for that frame has been waited on)
     m_garbage_index = (m_garbage_index + 1) % GARBAGE_SLOTS;
+    m_collect_count++;
 
-    // Destroy all geometries in this slot
+    // Return arena blocks of all geometries in this slot
     for (GeometryData* geometry : m_geometry_garbage[m_garbage_index]) {
-        DestroyBuffer(geometry->vertex_buffer, geometry->vertex_memory);
-        DestroyBuffer(geometry->index_buffer, geometry->index_memory);
+        ArenaFree(geometry->block);
         delete geometry;
     }
     m_geometry_garbage[m_garbage_index].clear();
 
-    // Destroy all textures in this slot
-    for (TextureData* texture : m_texture_garbage[m_garbage_index]) {
+    EvictMergedBatches(false);
+
+    // Destroy all textures in this slot, unless their upload is still in flight;
+    // those wait another round.
+    std::vector<TextureData*>& textures = m_texture_garbage[m_garbage_index];
+    std::vector<TextureData*>& next_slot = m_texture_garbage[(m_garbage_index + 1) % GARBAGE_SLOTS];
+    for (TextureData* texture : textures) {
+        if (texture->upload_serial > m_completed_upload_serial) {
+            next_slot.push_back(texture);
+            continue;
+        }
         DestroyTexture(texture);
         delete texture;
     }
-    m_texture_garbage[m_garbage_index].clear();
+    textures.clear();
 }
 
 void RenderInterface_VK::SetCommandBuffer(VkCommandBuffer cmd)
 {
+    // Held-back draws belong to the command buffer they were issued against;
+    // a captured frame has none yet and goes to this one.
+    if (m_current_cmd != VK_NULL_HANDLE) {
+        FlushDraws();
+    }
     m_current_cmd = cmd;
+    m_bound = BoundState{};
 }
 
 Rml::CompiledGeometryHandle RenderInterface_VK::CompileGeometry(
     Rml::Span<const Rml::Vertex> vertices, Rml::Span<const int> indices)
 {
-    auto* geometry = new GeometryData();
-    geometry->num_indices = static_cast<int>(indices.size());
+    if (vertices.empty() || indices.empty()) return 0;
 
-    // Create vertex buffer
+    // Vertices and indices share one arena block: [vertices][pad to 4][indices]
     VkDeviceSize vertex_size = vertices.size() * sizeof(Rml::Vertex);
-    geometry->vertex_buffer = CreateBuffer(
-        vertex_size,
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        geometry->vertex_memory
-    );
+    VkDeviceSize index_offset = AlignUp(vertex_size, sizeof(int));
+    VkDeviceSize index_size = indices.size() * sizeof(int);
 
-    if (geometry->vertex_buffer == VK_NULL_HANDLE) {
-        delete geometry;
+    ArenaBlock block;
+    if (!ArenaAllocate(index_offset + index_size, block)) {
+        Rml::Log::Message(Rml::Log::LT_ERROR, "Failed to allocate %llu bytes of geometry",
+                          static_cast<unsigned long long>(index_offset + index_size));
         return 0;
     }
 
-    // Copy vertex data
-    void* data;
-    vkMapMemory(m_config.device, geometry->vertex_memory, 0, vertex_size, 0, &data);
-    memcpy(data, vertices.data(), vertex_size);
-    vkUnmapMemory(m_config.device, geometry->vertex_memory);
+    ArenaChunk& chunk = m_arena_chunks[block.chunk];
+    memcpy(chunk.allocation.mapped + block.offset, vertices.data(), vertex_size);
+    memcpy(chunk.allocation.mapped + block.offset + index_offset, indices.data(), index_size);
 
-    // Create index buffer
-    VkDeviceSize index_size = indices.size() * sizeof(int);
-    geometry->index_buffer = CreateBuffer(
-        index_size,
-        VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        geometry->index_memory
-    );
+    auto* geometry = new GeometryData();
+    geometry->block = block;
+    geometry->buffer = chunk.buffer;
+    geometry->first_index = static_cast<uint32_t>((block.offset + index_offset) / sizeof(int));
+    geometry->base_vertex = static_cast<int32_t>(block.offset / sizeof(Rml::Vertex));
+    geometry->num_indices = static_cast<int>(indices.size());
 
-    if (geometry->index_buffer == VK_NULL_HANDLE) {
-        DestroyBuffer(geometry->vertex_buffer, geometry->vertex_memory);
-        delete geometry;
-        return 0;
+    Rml::CompiledGeometryHandle handle = m_next_geometry_handle++;
+    geometry->id = static_cast<uint64_t>(handle);
+
+    geometry->bounds_min = vertices[0].position;
+    geometry->bounds_max = vertices[0].position;
+    for (const Rml::Vertex& vertex : vertices) {
+        geometry->bounds_min.x = std::min(geometry->bounds_min.x, vertex.position.x);
+        geometry->bounds_min.y = std::min(geometry->bounds_min.y, vertex.position.y);
+        geometry->bounds_max.x = std::max(geometry->bounds_max.x, vertex.position.x);
+        geometry->bounds_max.y = std::max(geometry->bounds_max.y, vertex.position.y);
     }
 
-    // Copy index data
-    vkMapMemory(m_config.device, geometry->index_memory, 0, index_size, 0, &data);
-    memcpy(data, indices.data(), index_size);
-    vkUnmapMemory(m_config.device, geometry->index_memory);
+    if (vertices.size() <= MERGE_MAX_VERTICES) {
+        geometry->vertices.assign(vertices.begin(), vertices.end());
+        geometry->indices.assign(indices.begin(), indices.end());
+    }
 
-    Rml::CompiledGeometryHandle handle = m_next_geometry_handle++;
     m_geometries[handle] = geometry;
     return handle;
 }
@@ -311,7 +459,7 @@ void RenderInterface_VK::RenderGeometry(Rml::CompiledGeometryHandle geometry_han
                                          Rml::Vector2f translation,
                                          Rml::TextureHandle texture_handle)
 {
-    if (m_current_cmd == VK_NULL_HANDLE) return;
+    if (!m_in_frame) return;
 
     auto geom_it = m_geometries.find(geometry_handle);
     if (geom_it == m_geometries.end()) return;
@@ -326,79 +474,642 @@ void RenderInterface_VK::RenderGeometry(Rml::CompiledGeometryHandle geometry_han
         }
     }
 
-    // Use white texture if no texture specified
-    if (!texture) {
+    // Use white texture if no texture specified, or if it could not be
+    // decoded (as when a failed load returned no handle)
+    if (!texture || texture->failed) {
         texture = m_white_texture;
+    } else if (texture->pending) {
+        texture = m_placeholder_texture;
     }
 
-    // Select pipeline based on whether we have a texture
-    VkPipeline pipeline = texture ? m_pipeline_textured : m_pipeline_untextured;
-
-    // Bind pipeline
-    auto bind_pipeline = m_config.cmd_bind_pipeline ? m_config.cmd_bind_pipeline : vkCmdBindPipeline;
-    bind_pipeline(m_current_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    // Capture the state the draw needs; it is recorded when the list is flushed
+    DrawCommand draw{};
+    draw.geometry = geometry;
+    draw.transform = static_cast<uint32_t>(m_frame_transforms.size() - 1);
+    draw.translation = translation;
+    draw.pipeline = texture ? m_pipeline_textured : m_pipeline_untextured;
+    if (m_bindless) {
+        draw.descriptor_set = m_bindless_set;
+        draw.texture_index = texture ? texture->slot : 0;
+    } else {
+        draw.descriptor_set = texture ? texture->descriptor_set : VK_NULL_HANDLE;
+    }
 
-    // Set scissor
-    auto set_scissor = m_config.cmd_set_scissor ? m_config.cmd_set_scissor : vkCmdSetScissor;
     if (m_scissor_enabled) {
-        set_scissor(m_current_cmd, 0, 1, &m_scissor_rect);
+        draw.scissor = m_scissor_rect;
     } else {
-        VkRect2D full_scissor = {{0, 0}, {static_cast<uint32_t>(m_viewport_width),
-                                          static_cast<uint32_t>(m_viewport_height)}};
-        set_scissor(m_current_cmd, 0, 1, &full_scissor);
+        draw.scissor = {{0, 0}, {static_cast<uint32_t>(m_viewport_width),
+                                 static_cast<uint32_t>(m_viewport_height)}};
     }
 
-    // Bind texture descriptor set
-    if (texture && texture->descriptor_set) {
-        auto bind_desc = m_config.cmd_bind_descriptor_sets ? m_config.cmd_bind_descriptor_sets
-                                                           : vkCmdBindDescriptorSets;
-        bind_desc(m_current_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline_layout,
-                  0, 1, &texture->descriptor_set, 0, nullptr);
+    // Partial redraw keeps a key and the covered pixels of every draw. The key
+    // hashes the MVP itself, since transform indices shift between frames.
+    if (m_config.partial_redraw && !m_config.secondary_command_buffers) {
+        draw.bounds = ComputeDrawBounds(geometry, translation, draw.scissor);
+
+        uint64_t key = HashBytes(FNV_OFFSET_BASIS, &m_viewport_width, sizeof(m_viewport_width));
+        key = HashBytes(key, &m_viewport_height, sizeof(m_viewport_height));
+        key = HashBytes(key, &geometry_handle, sizeof(geometry_handle));
+        key = HashBytes(key, &texture_handle, sizeof(texture_handle));
+        key = HashBytes(key, m_mvp.data(), sizeof(float) * 16);
+        key = HashBytes(key, &draw.translation, sizeof(draw.translation));
+        key = HashBytes(key, &draw.pipeline, sizeof(draw.pipeline));
+        key = HashBytes(key, &draw.descriptor_set, sizeof(draw.descriptor_set));
+        key = HashBytes(key, &draw.texture_index, sizeof(draw.texture_index));
+        key = HashBytes(key, &draw.scissor, sizeof(draw.scissor));
+        m_frame_records.push_back({key, draw.bounds});
     }
 
-    // Push constants with transform and translation
-    PushConstants push_constants{};
+    m_draw_list.push_back(draw);
+    m_frame_stats.geometry_draws++;
+
+    // Handles are never reused, so they identify the geometry and texture
+    // contents; the resolved set and index catch textures that finished decoding.
+    HashFrameData(&geometry_handle, sizeof(geometry_handle));
+    HashFrameData(&texture_handle, sizeof(texture_handle));
+    HashFrameData(&draw.transform, sizeof(draw.transform));
+    HashFrameData(&draw.translation, sizeof(draw.translation));
+    HashFrameData(&draw.pipeline, sizeof(draw.pipeline));
+    HashFrameData(&draw.descriptor_set, sizeof(draw.descriptor_set));
+    HashFrameData(&draw.texture_index, sizeof(draw.texture_index));
+    HashFrameData(&draw.scissor, sizeof(draw.scissor));
+}
 
-    // Build orthographic projection matrix
-    float L = 0.0f;
-    float R = static_cast<float>(m_viewport_width);
-    float T = 0.0f;
-    float B = static_cast<float>(m_viewport_height);
+void RenderInterface_VK::FlushDraws()
+{
+    if (m_current_cmd != VK_NULL_HANDLE) {
+        // With secondary command buffers the engine's subpass only takes
+        // vkCmdExecuteCommands; the viewport is set inside the recording instead.
+        if (!m_config.secondary_command_buffers) {
+            SetViewport();
+            if (m_partial_frame) {
+                RecordDirtyRects();
+            } else {
+                RecordDrawList(m_draw_list, nullptr);
+            }
+        } else if (!m_draw_list.empty() && !RecordCachedFrame()) {
+            Rml::Log::Message(Rml::Log::LT_ERROR, "Failed to record UI frame");
+        }
+        m_recorded_hash = m_frame_hash;
+        m_recorded_records = m_frame_records;
+    }
 
-    Rml::Matrix4f projection = Rml::Matrix4f::FromRows(
-        {2.0f / (R - L), 0.0f, 0.0f, (R + L) / (L - R)},
-        {0.0f, 2.0f / (B - T), 0.0f, (T + B) / (T - B)},
-        {0.0f, 0.0f, -1.0f, 0.0f},
-        {0.0f, 0.0f, 0.0f, 1.0f}
-    );
+    // Draws that follow only have to match the next recording
+    m_draw_list.clear();
+    m_partial_frame = false;
+    ResetFrameHash();
+}
 
-    Rml::Matrix4f mvp = projection;
-    if (m_transform_enabled) {
-        mvp = projection * m_transform;
+ui_frame_update_t RenderInterface_VK::EvaluateFrame()
+{
+    m_dirty_rects.clear();
+    m_partial_frame = false;
+
+    if (m_recorded_hash != 0 && m_frame_hash == m_recorded_hash) {
+        return UI_FRAME_UNCHANGED;
     }
 
-    memcpy(push_constants.transform, mvp.data(), sizeof(push_constants.transform));
-    push_constants.translation[0] = translation.x;
-    push_constants.translation[1] = translation.y;
+    // Only a captured frame can be compared draw by draw against the last image
+    if (!m_config.partial_redraw || m_config.secondary_command_buffers ||
+        m_recorded_hash == 0 || m_current_cmd != VK_NULL_HANDLE) {
+        return UI_FRAME_FULL;
+    }
 
-    auto push_const = m_config.cmd_push_constants ? m_config.cmd_push_constants : vkCmdPushConstants;
-    push_const(m_current_cmd, m_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0,
-               sizeof(PushConstants), &push_constants);
+    // Match draws by key. Unmatched ones changed: the pixels they cover now and
+    // the pixels they covered before are dirty.
+    std::unordered_map<uint64_t, int> recorded_counts;
+    recorded_counts.reserve(m_recorded_records.size());
+    for (const DrawRecord& record : m_recorded_records) {
+        recorded_counts[record.key]++;
+    }
 
-    // Bind vertex buffer
-    VkDeviceSize offset = 0;
-    auto bind_vb = m_config.cmd_bind_vertex_buffers ? m_config.cmd_bind_vertex_buffers
-                                                    : vkCmdBindVertexBuffers;
-    bind_vb(m_current_cmd, 0, 1, &geometry->vertex_buffer, &offset);
+    std::vector<uint64_t> kept;
+    kept.reserve(m_frame_records.size());
+    for (const DrawRecord& record : m_frame_records) {
+        auto it = recorded_counts.find(record.key);
+        if (it != recorded_counts.end() && it->second > 0) {
+            it->second--;
+            kept.push_back(record.key);
+        } else {
+            AddDirtyRect(record.bounds);
+        }
+    }
 
-    // Bind index buffer
-    auto bind_ib = m_config.cmd_bind_index_buffer ? m_config.cmd_bind_index_buffer
-                                                  : vkCmdBindIndexBuffer;
-    bind_ib(m_current_cmd, geometry->index_buffer, 0, VK_INDEX_TYPE_UINT32);
+    std::unordered_map<uint64_t, int> kept_counts;
+    kept_counts.reserve(kept.size());
+    for (uint64_t key : kept) {
+        kept_counts[key]++;
+    }
+
+    // Unchanged draws that swapped places could differ where they overlap,
+    // outside any dirty rect; leave that to a full redraw.
+    size_t kept_index = 0;
+    bool same_order = true;
+    for (const DrawRecord& record : m_recorded_records) {
+        auto it = kept_counts.find(record.key);
+        if (it != kept_counts.end() && it->second > 0) {
+            it->second--;
+            same_order = same_order && kept[kept_index] == record.key;
+            kept_index++;
+        } else {
+            AddDirtyRect(record.bounds);
+        }
+    }
+
+    if (!same_order || m_dirty_rects.empty()) {
+        m_dirty_rects.clear();
+        return UI_FRAME_FULL;
+    }
+
+    uint64_t dirty_area = 0;
+    for (const VkRect2D& rect : m_dirty_rects) {
+        dirty_area += static_cast<uint64_t>(rect.extent.width) * rect.extent.height;
+    }
+    uint64_t screen_area = static_cast<uint64_t>(m_viewport_width) * m_viewport_height;
+    if (dirty_area > screen_area * MAX_PARTIAL_AREA) {
+        m_dirty_rects.clear();
+        return UI_FRAME_FULL;
+    }
+
+    m_partial_frame = true;
+    m_frame_stats.dirty_rects = static_cast<unsigned int>(m_dirty_rects.size());
+    return UI_FRAME_PARTIAL;
+}
+
+VkRect2D RenderInterface_VK::ComputeDrawBounds(const GeometryData* geometry, Rml::Vector2f translation,
+                                                const VkRect2D& scissor) const
+{
+    const float xs[2] = {geometry->bounds_min.x + translation.x, geometry->bounds_max.x + translation.x};
+    const float ys[2] = {geometry->bounds_min.y + translation.y, geometry->bounds_max.y + translation.y};
+
+    float min_x = 0.0f, min_y = 0.0f, max_x = 0.0f, max_y = 0.0f;
+    for (int i = 0; i < 4; ++i) {
+        Rml::Vector4f clip = m_mvp * Rml::Vector4f(xs[i & 1], ys[i >> 1], 0.0f, 1.0f);
+
+        // A corner behind the eye of a perspective transform: assume the whole scissor
+        if (clip.w <= 0.0f) {
+            return scissor;
+        }
 
-    // Draw
+        // The projection maps the top-left corner to (-1, -1)
+        float x = (clip.x / clip.w + 1.0f) * 0.5f * static_cast<float>(m_viewport_width);
+        float y = (clip.y / clip.w + 1.0f) * 0.5f * static_cast<float>(m_viewport_height);
+        min_x = i == 0 ? x : std::min(min_x, x);
+        min_y = i == 0 ? y : std::min(min_y, y);
+        max_x = i == 0 ? x : std::max(max_x, x);
+        max_y = i == 0 ? y : std::max(max_y, y);
+    }
+
+    // Clamped to the scissor before converting, then widened a pixel for
+    // rasterization rounding and antialiased edges
+    float left = static_cast<float>(scissor.offset.x);
+    float top = static_cast<float>(scissor.offset.y);
+    float right = left + static_cast<float>(scissor.extent.width);
+    float bottom = top + static_cast<float>(scissor.extent.height);
+
+    VkRect2D bounds{};
+    bounds.offset.x = static_cast<int32_t>(std::floor(std::clamp(min_x, left, right))) - 1;
+    bounds.offset.y = static_cast<int32_t>(std::floor(std::clamp(min_y, top, bottom))) - 1;
+    bounds.extent.width = static_cast<uint32_t>(
+        static_cast<int32_t>(std::ceil(std::clamp(max_x, left, right))) + 1 - bounds.offset.x);
+    bounds.extent.height = static_cast<uint32_t>(
+        static_cast<int32_t>(std::ceil(std::clamp(max_y, top, bottom))) + 1 - bounds.offset.y);
+    return RectIntersection(bounds, scissor);
+}
+
+void RenderInterface_VK::AddDirtyRect(VkRect2D rect)
+{
+    if (rect.extent.width == 0 || rect.extent.height == 0) return;
+
+    // Keep the rects disjoint so no pixel is cleared and drawn twice. Absorbing
+    // one rect can make the union overlap another, so scan until none does.
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < m_dirty_rects.size(); ++i) {
+            if (RectsOverlap(rect, m_dirty_rects[i])) {
+                rect = RectUnion(rect, m_dirty_rects[i]);
+                m_dirty_rects[i] = m_dirty_rects.back();
+                m_dirty_rects.pop_back();
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    // Too many separate regions: one bounding box costs fewer passes over the list
+    if (m_dirty_rects.size() >= MAX_DIRTY_RECTS) {
+        for (const VkRect2D& other : m_dirty_rects) {
+            rect = RectUnion(rect, other);
+        }
+        m_dirty_rects.clear();
+    }
+    m_dirty_rects.push_back(rect);
+}
+
+void RenderInterface_VK::RecordDirtyRects()
+{
+    // Wherever the UI draws nothing its image is transparent
+    VkClearAttachment clear{};
+    clear.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    clear.colorAttachment = 0;
+
+    std::vector<DrawCommand> draws;
+    for (const VkRect2D& rect : m_dirty_rects) {
+        VkClearRect clear_rect{};
+        clear_rect.rect = rect;
+        clear_rect.baseArrayLayer = 0;
+        clear_rect.layerCount = 1;
+        vkCmdClearAttachments(m_current_cmd, 1, &clear, 1, &clear_rect);
+
+        // Every draw touching the rect is redrawn, in order, clipped to it
+        draws.clear();
+        for (const DrawCommand& draw : m_draw_list) {
+            if (RectsOverlap(draw.bounds, rect)) {
+                DrawCommand clipped = draw;
+                clipped.scissor = RectIntersection(draw.scissor, rect);
+                draws.push_back(clipped);
+            }
+        }
+        RecordDrawList(draws, nullptr);
+    }
+}
+
+void RenderInterface_VK::RecordDrawList(const std::vector<DrawCommand>& draws, StreamBuffer* stream)
+{
+    auto mergeable = [](const DrawCommand& draw) { return !draw.geometry->vertices.empty(); };
+    auto same_state = [this](const DrawCommand& a, const DrawCommand& b) {
+        return a.pipeline == b.pipeline && a.descriptor_set == b.descriptor_set &&
+               a.texture_index == b.texture_index &&
+               (a.transform == b.transform ||
+                m_frame_transforms[a.transform] == m_frame_transforms[b.transform]) &&
+               a.scissor.offset.x == b.scissor.offset.x && a.scissor.offset.y == b.scissor.offset.y &&
+               a.scissor.extent.width == b.scissor.extent.width &&
+               a.scissor.extent.height == b.scissor.extent.height;
+    };
+
+    // Runs of small geometry sharing pipeline, texture, transform and scissor become one draw
+    size_t i = 0;
+    while (i < draws.size()) {
+        size_t end = i + 1;
+        if (mergeable(draws[i])) {
+            while (end < draws.size() && mergeable(draws[end]) &&
+                   same_state(draws[i], draws[end])) {
+                ++end;
+            }
+        }
+
+        if (end - i < 2 || !RecordMergedDraws(&draws[i], end - i, stream)) {
+            for (size_t k = i; k < end; ++k) {
+                RecordDraw(draws[k]);
+            }
+        }
+        i = end;
+    }
+}
+
+void RenderInterface_VK::RecordDraw(const DrawCommand& draw)
+{
+    BindPipeline(draw.pipeline);
+    SetScissor(draw.scissor);
+    if (draw.descriptor_set) {
+        BindDescriptorSet(draw.descriptor_set);
+    }
+    if (m_bindless) {
+        SetTextureIndex(draw.texture_index);
+    }
+
+    PushDrawConstants(draw.transform, draw.translation);
+    BindGeometryBuffer(draw.geometry->buffer);
+
+    // Geometry lives at an offset inside its arena chunk; the chunk is bound once
+    // and each draw selects its range with firstIndex and vertexOffset.
+    const GeometryData* geometry = draw.geometry;
     auto draw_indexed = m_config.cmd_draw_indexed ? m_config.cmd_draw_indexed : vkCmdDrawIndexed;
-    draw_indexed(m_current_cmd, geometry->num_indices, 1, 0, 0, 0);
+    draw_indexed(m_current_cmd, geometry->num_indices, 1, geometry->first_index, geometry->base_vertex, 0);
+    m_frame_stats.draw_calls++;
+}
+
+bool RenderInterface_VK::RecordMergedDraws(const DrawCommand* draws, size_t count, StreamBuffer* stream)
+{
+    VkBuffer buffer;
+    uint32_t first_index;
+    int32_t base_vertex;
+    int num_indices;
+
+    if (stream) {
+        size_t num_vertices = 0;
+        num_indices = 0;
+        for (size_t i = 0; i < count; ++i) {
+            num_vertices += draws[i].geometry->vertices.size();
+            num_indices += static_cast<int>(draws[i].geometry->indices.size());
+        }
+
+        // Same layout as an arena block: [vertices][pad to 4][indices]
+        VkDeviceSize vertex_size = num_vertices * sizeof(Rml::Vertex);
+        VkDeviceSize index_offset = AlignUp(vertex_size, sizeof(int));
+        VkDeviceSize size = AlignUp(index_offset + num_indices * sizeof(int), ARENA_ALIGNMENT);
+
+        stream->demand += size;
+        if (stream->buffer == VK_NULL_HANDLE || stream->cursor + size > stream->size) {
+            return false;
+        }
+
+        VkDeviceSize offset = stream->cursor;
+        stream->cursor += size;
+        WriteMergedBatch(draws, count, stream->allocation.mapped + offset, index_offset);
+
+        buffer = stream->buffer;
+        first_index = static_cast<uint32_t>((offset + index_offset) / sizeof(int));
+        base_vertex = static_cast<int32_t>(offset / sizeof(Rml::Vertex));
+    } else {
+        const GeometryData* batch = AcquireMergedBatch(draws, count);
+        if (!batch) {
+            return false;
+        }
+
+        buffer = batch->buffer;
+        first_index = batch->first_index;
+        base_vertex = batch->base_vertex;
+        num_indices = batch->num_indices;
+    }
+
+    BindPipeline(draws[0].pipeline);
+    SetScissor(draws[0].scissor);
+    if (draws[0].descriptor_set) {
+        BindDescriptorSet(draws[0].descriptor_set);
+    }
+    if (m_bindless) {
+        SetTextureIndex(draws[0].texture_index);
+    }
+
+    // Translation is baked into the positions, so the batch draws at the origin
+    PushDrawConstants(draws[0].transform, Rml::Vector2f(0.0f, 0.0f));
+    BindGeometryBuffer(buffer);
+
+    auto draw_indexed = m_config.cmd_draw_indexed ? m_config.cmd_draw_indexed : vkCmdDrawIndexed;
+    draw_indexed(m_current_cmd, static_cast<uint32_t>(num_indices), 1, first_index, base_vertex, 0);
+    m_frame_stats.draw_calls++;
+    m_frame_stats.merged_draws += static_cast<unsigned int>(count - 1);
+    return true;
+}
+
+RenderInterface_VK::GeometryData* RenderInterface_VK::AcquireMergedBatch(const DrawCommand* draws, size_t count)
+{
+    uint64_t key = HashBytes(FNV_OFFSET_BASIS, &count, sizeof(count));
+    size_t num_vertices = 0;
+    size_t num_indices = 0;
+    for (size_t i = 0; i < count; ++i) {
+        key = HashBytes(key, &draws[i].geometry->id, sizeof(draws[i].geometry->id));
+        key = HashBytes(key, &draws[i].translation, sizeof(draws[i].translation));
+        num_vertices += draws[i].geometry->vertices.size();
+        num_indices += draws[i].geometry->indices.size();
+    }
+
+    // Same run as a recent frame: its batch is still in the arena
+    auto it = m_merged_batches.find(key);
+    if (it != m_merged_batches.end()) {
+        it->second.last_used = m_collect_count;
+        return it->second.geometry;
+    }
+
+    // Same layout as CompileGeometry: [vertices][pad to 4][indices]
+    VkDeviceSize vertex_size = num_vertices * sizeof(Rml::Vertex);
+    VkDeviceSize index_offset = AlignUp(vertex_size, sizeof(int));
+    VkDeviceSize index_size = num_indices * sizeof(int);
+
+    ArenaBlock block;
+    if (!ArenaAllocate(index_offset + index_size, block)) {
+        return nullptr;
+    }
+
+    ArenaChunk& chunk = m_arena_chunks[block.chunk];
+    WriteMergedBatch(draws, count, chunk.allocation.mapped + block.offset, index_offset);
+
+    auto* batch = new GeometryData();
+    batch->block = block;
+    batch->buffer = chunk.buffer;
+    batch->first_index = static_cast<uint32_t>((block.offset + index_offset) / sizeof(int));
+    batch->base_vertex = static_cast<int32_t>(block.offset / sizeof(Rml::Vertex));
+    batch->num_indices = static_cast<int>(num_indices);
+    batch->id = 0;
+
+    m_merged_batches[key] = MergedBatch{batch, m_collect_count};
+    m_frame_stats.batches_built++;
+    return batch;
+}
+
+void RenderInterface_VK::WriteMergedBatch(const DrawCommand* draws, size_t count, uint8_t* out,
+                                          VkDeviceSize index_offset)
+{
+    auto* out_vertices = reinterpret_cast<Rml::Vertex*>(out);
+    auto* out_indices = reinterpret_cast<int*>(out + index_offset);
+    int vertex_base = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        const GeometryData* geometry = draws[i].geometry;
+        const Rml::Vector2f translation = draws[i].translation;
+
+        for (const Rml::Vertex& vertex : geometry->vertices) {
+            Rml::Vertex translated = vertex;
+            translated.position.x += translation.x;
+            translated.position.y += translation.y;
+            *out_vertices++ = translated;
+        }
+        for (int index : geometry->indices) {
+            *out_indices++ = index + vertex_base;
+        }
+        vertex_base += static_cast<int>(geometry->vertices.size());
+    }
+}
+
+void RenderInterface_VK::EvictMergedBatches(bool all)
+{
+    // A batch idle for longer than GARBAGE_SLOTS collections is no longer read by
+    // any frame in flight, so its block can go back to the arena directly.
+    static_assert(MERGED_BATCH_LIFETIME >= GARBAGE_SLOTS, "batches must outlive the frames drawing them");
+
+    for (auto it = m_merged_batches.begin(); it != m_merged_batches.end();) {
+        if (all || it->second.last_used + MERGED_BATCH_LIFETIME <= m_collect_count) {
+            ArenaFree(it->second.geometry->block);
+            delete it->second.geometry;
+            it = m_merged_batches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool RenderInterface_VK::CreateStreamBuffer(StreamBuffer& stream, VkDeviceSize size)
+{
+    stream = StreamBuffer{};
+    stream.buffer = CreateBuffer(
+        size,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        stream.allocation
+    );
+
+    if (stream.buffer == VK_NULL_HANDLE) {
+        Rml::Log::Message(Rml::Log::LT_WARNING, "Failed to create %llu KB draw batch buffer",
+                          static_cast<unsigned long long>(size / 1024));
+        return false;
+    }
+
+    stream.size = size;
+    return true;
+}
+
+void RenderInterface_VK::ResetStreamBuffer(StreamBuffer& stream)
+{
+    // Grow if batches were dropped last time round; nothing reads the old buffer anymore
+    if (stream.buffer != VK_NULL_HANDLE && stream.demand > stream.size) {
+        VkDeviceSize size = stream.size;
+        while (size < stream.demand) {
+            size *= 2;
+        }
+        DestroyBuffer(stream.buffer, stream.allocation);
+        CreateStreamBuffer(stream, size);
+    }
+
+    stream.cursor = 0;
+    stream.demand = 0;
+}
+
+void RenderInterface_VK::ResetFrameHash()
+{
+    m_frame_hash = FNV_OFFSET_BASIS;
+    HashFrameData(&m_viewport_width, sizeof(m_viewport_width));
+    HashFrameData(&m_viewport_height, sizeof(m_viewport_height));
+
+    if (!m_frame_transforms.empty()) {
+        HashFrameData(m_mvp.data(), sizeof(float) * 16);
+    }
+}
+
+void RenderInterface_VK::HashFrameData(const void* data, size_t size)
+{
+    m_frame_hash = HashBytes(m_frame_hash, data, size);
+}
+
+uint64_t RenderInterface_VK::HashBytes(uint64_t hash, const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+bool RenderInterface_VK::RecordCachedFrame()
+{
+    VkCommandBuffer primary = m_current_cmd;
+
+    // Same draws, textures, scissors and transforms as the recorded frame: replay it
+    if (m_cached_recording >= 0 && m_cached_hash == m_frame_hash) {
+        CachedRecording& recording = m_recordings[m_cached_recording];
+        vkCmdExecuteCommands(primary, 1, &recording.cmd);
+        recording.last_used = m_collect_count;
+        m_frame_stats.replayed = 1;
+        return true;
+    }
+
+    m_cached_recording = -1;
+
+    int index = AcquireRecording();
+    if (index < 0) {
+        return false;
+    }
+    CachedRecording& recording = m_recordings[index];
+
+    VkCommandBufferInheritanceInfo inheritance{};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = m_config.render_pass;
+    inheritance.subpass = m_config.subpass;
+
+    // Simultaneous use: a replay can be submitted while the previous frame's is in flight
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                       VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+    begin_info.pInheritanceInfo = &inheritance;
+
+    if (vkBeginCommandBuffer(recording.cmd, &begin_info) != VK_SUCCESS) {
+        return false;
+    }
+
+    // Secondary command buffers inherit no state from the primary
+    m_current_cmd = recording.cmd;
+    m_bound = BoundState{};
+    ResetStreamBuffer(recording.stream);
+    SetViewport();
+    RecordDrawList(m_draw_list, &recording.stream);
+    m_current_cmd = primary;
+
+    if (vkEndCommandBuffer(recording.cmd) != VK_SUCCESS) {
+        return false;
+    }
+
+    vkCmdExecuteCommands(primary, 1, &recording.cmd);
+    recording.last_used = m_collect_count;
+    m_cached_recording = index;
+    m_cached_hash = m_frame_hash;
+    return true;
+}
+
+int RenderInterface_VK::AcquireRecording()
+{
+    // A recording can be rewritten once the frames that executed it have completed
+    for (size_t i = 0; i < m_recordings.size(); ++i) {
+        if (m_recordings[i].last_used + GARBAGE_SLOTS <= m_collect_count) {
+            return static_cast<int>(i);
+        }
+    }
+
+    if (m_recording_pool == VK_NULL_HANDLE) {
+        VkCommandPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        pool_info.queueFamilyIndex = m_config.queue_family_index;
+
+        if (vkCreateCommandPool(m_config.device, &pool_info, nullptr, &m_recording_pool) != VK_SUCCESS) {
+            m_recording_pool = VK_NULL_HANDLE;
+            return -1;
+        }
+    }
+
+    CachedRecording recording{};
+
+    VkCommandBufferAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.commandPool = m_recording_pool;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    alloc_info.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(m_config.device, &alloc_info, &recording.cmd) != VK_SUCCESS) {
+        return -1;
+    }
+
+    // Without a batch buffer the recording just draws unmerged
+    CreateStreamBuffer(recording.stream, STREAM_BUFFER_SIZE);
+
+    m_recordings.push_back(recording);
+    return static_cast<int>(m_recordings.size() - 1);
+}
+
+void RenderInterface_VK::DestroyRecordings()
+{
+    for (CachedRecording& recording : m_recordings) {
+        DestroyBuffer(recording.stream.buffer, recording.stream.allocation);
+    }
+    m_recordings.clear();
+    m_cached_recording = -1;
+
+    // Frees the command buffers with it
+    if (m_recording_pool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(m_config.device, m_recording_pool, nullptr);
+        m_recording_pool = VK_NULL_HANDLE;
+    }
 }
 
 void RenderInterface_VK::ReleaseGeometry(Rml::CompiledGeometryHandle geometry_handle)
@@ -428,14 +1139,11 @@ Rml::TextureHandle RenderInterface_VK::LoadTexture(Rml::Vector2i& texture_dimens
     file_interface->Read(file_data.data(), file_size, file);
     file_interface->Close(file);
 
-    // Use stb_image to decode the image
+    // Only parse the header here; layout needs the dimensions right away,
+    // the pixels can follow later.
     int width, height, channels;
-    unsigned char* image_data = stbi_load_from_memory(
-        file_data.data(), static_cast<int>(file_size),
-        &width, &height, &channels, 4  // Force RGBA output
-    );
-
-    if (!image_data) {
+    if (!stbi_info_from_memory(file_data.data(), static_cast<int>(file_size),
+                               &width, &height, &channels)) {
         Rml::Log::Message(Rml::Log::LT_WARNING, "Failed to decode texture: %s (%s)",
                           source.c_str(), stbi_failure_reason());
         return 0;
@@ -444,18 +1152,44 @@ Rml::TextureHandle RenderInterface_VK::LoadTexture(Rml::Vector2i& texture_dimens
     texture_dimensions.x = width;
     texture_dimensions.y = height;
 
-    // Generate the texture using the decoded image data
-    Rml::TextureHandle handle = GenerateTexture(
-        Rml::Span<const Rml::byte>(image_data, width * height * 4),
-        texture_dimensions
+    TextureData* texture = CreateTexture(texture_dimensions);
+    if (!texture) {
+        return 0;
+    }
+
+    // Workers decode into this mapped staging buffer; the upload is recorded
+    // once the pixels are there. Until then the texture draws as the placeholder,
+    // and as white if they never arrive.
+    StagingBuffer staging{};
+    staging.buffer = CreateBuffer(
+        static_cast<VkDeviceSize>(width) * height * 4,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        staging.allocation
     );
 
-    stbi_image_free(image_data);
+    if (staging.buffer == VK_NULL_HANDLE) {
+        DestroyTexture(texture);
+        delete texture;
+        return 0;
+    }
 
-    if (handle) {
-        Rml::Log::Message(Rml::Log::LT_INFO, "Loaded texture: %s (%dx%d)",
-                          source.c_str(), width, height);
+    texture->pending = true;
+
+    Rml::TextureHandle handle = m_next_texture_handle++;
+    m_textures[handle] = texture;
+
+    DecodeJob job;
+    job.handle = handle;
+    job.source = source;
+    job.file_data = std::move(file_data);
+    job.staging = staging;
+    job.dimensions = texture_dimensions;
+    {
+        std::lock_guard<std::mutex> lock(m_decode_mutex);
+        m_decode_jobs.push_back(std::move(job));
     }
+    m_decode_cv.notify_one();
 
     return handle;
 }
@@ -463,32 +1197,53 @@ Rml::TextureHandle RenderInterface_VK::LoadTexture(Rml::Vector2i& texture_dimens
 Rml::TextureHandle RenderInterface_VK::GenerateTexture(Rml::Span<const Rml::byte> source,
                                                         Rml::Vector2i source_dimensions)
 {
-    auto* texture = new TextureData();
-    texture->dimensions = source_dimensions;
-
-    VkDeviceSize image_size = source_dimensions.x * source_dimensions.y * 4;
+    VkDeviceSize image_size = static_cast<VkDeviceSize>(source_dimensions.x) * source_dimensions.y * 4;
 
     // Create staging buffer
-    VkBuffer staging_buffer;
-    VkDeviceMemory staging_memory;
-    staging_buffer = CreateBuffer(
+    StagingBuffer staging{};
+    staging.buffer = CreateBuffer(
         image_size,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        staging_memory
+        staging.allocation
     );
 
-    void* data;
-    vkMapMemory(m_config.device, staging_memory, 0, image_size, 0, &data);
-    memcpy(data, source.data(), image_size);
-    vkUnmapMemory(m_config.device, staging_memory);
+    if (staging.buffer == VK_NULL_HANDLE) {
+        return 0;
+    }
+
+    memcpy(staging.allocation.mapped, source.data(), image_size);
+
+    TextureData* texture = CreateTexture(source_dimensions);
+    if (!texture) {
+        DestroyBuffer(staging.buffer, staging.allocation);
+        return 0;
+    }
+
+    if (!RecordTextureUpload(texture, staging)) {
+        DestroyBuffer(staging.buffer, staging.allocation);
+        DestroyTexture(texture);
+        delete texture;
+        return 0;
+    }
+
+    Rml::TextureHandle handle = m_next_texture_handle++;
+    m_textures[handle] = texture;
+    return handle;
+}
+
+RenderInterface_VK::TextureData* RenderInterface_VK::CreateTexture(Rml::Vector2i dimensions)
+{
+    auto* texture = new TextureData();
+    texture->dimensions = dimensions;
+    texture->slot = NO_TEXTURE_SLOT;
 
     // Create image
     VkImageCreateInfo image_info{};
     image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     image_info.imageType = VK_IMAGE_TYPE_2D;
-    image_info.extent.width = source_dimensions.x;
-    image_info.extent.height = source_dimensions.y;
+    image_info.extent.width = dimensions.x;
+    image_info.extent.height = dimensions.y;
     image_info.extent.depth = 1;
     image_info.mipLevels = 1;
     image_info.arrayLayers = 1;
@@ -500,52 +1255,97 @@ Rml::TextureHandle RenderInterface_VK::GenerateTexture(Rml::Span<const Rml::byte
     image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
     if (vkCreateImage(m_config.device, &image_info, nullptr, &texture->image) != VK_SUCCESS) {
-        DestroyBuffer(staging_buffer, staging_memory);
         delete texture;
-        return 0;
+        return nullptr;
     }
 
     // Allocate image memory
     VkMemoryRequirements mem_reqs;
     vkGetImageMemoryRequirements(m_config.device, texture->image, &mem_reqs);
 
-    VkMemoryAllocateInfo alloc_info{};
-    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    alloc_info.allocationSize = mem_reqs.size;
-    alloc_info.memoryTypeIndex = FindMemoryType(mem_reqs.memoryTypeBits,
-                                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(m_config.device, &alloc_info, nullptr, &texture->memory) != VK_SUCCESS) {
+    if (!m_memory_heap.Allocate(mem_reqs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                MemoryKind::Image, texture->allocation)) {
         vkDestroyImage(m_config.device, texture->image, nullptr);
-        DestroyBuffer(staging_buffer, staging_memory);
         delete texture;
-        return 0;
+        return nullptr;
+    }
+
+    vkBindImageMemory(m_config.device, texture->image, texture->allocation.memory,
+                      texture->allocation.offset);
+
+    // Create image view
+    VkImageViewCreateInfo view_info{};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = texture->image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view_info.subresourceRange.baseMipLevel = 0;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.baseArrayLayer = 0;
+    view_info.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(m_config.device, &view_info, nullptr, &texture->view) != VK_SUCCESS) {
+        texture->view = VK_NULL_HANDLE;
+        DestroyTexture(texture);
+        delete texture;
+        return nullptr;
     }
 
-    vkBindImageMemory(m_config.device, texture->image, texture->memory, 0);
+    texture->sampler = m_sampler;
 
-    // Create command buffer for image transfer
-    VkCommandPoolCreateInfo pool_info{};
-    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    pool_info.queueFamilyIndex = m_config.queue_family_index;
-    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    // Bindless: claim a slot in the global array instead of a set of its own
+    if (m_bindless) {
+        if (!AllocateTextureSlot(texture->slot)) {
+            DestroyTexture(texture);
+            delete texture;
+            return nullptr;
+        }
+    }
 
-    VkCommandPool cmd_pool;
-    vkCreateCommandPool(m_config.device, &pool_info, nullptr, &cmd_pool);
+    // Allocate descriptor set for this texture
+    VkDescriptorSetAllocateInfo desc_alloc_info{};
+    desc_alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    desc_alloc_info.descriptorPool = m_descriptor_pool;
+    desc_alloc_info.descriptorSetCount = 1;
+    desc_alloc_info.pSetLayouts = &m_texture_set_layout;
 
-    VkCommandBufferAllocateInfo cmd_alloc_info{};
-    cmd_alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    cmd_alloc_info.commandPool = cmd_pool;
-    cmd_alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmd_alloc_info.commandBufferCount = 1;
+    if (!m_bindless &&
+        vkAllocateDescriptorSets(m_config.device, &desc_alloc_info, &texture->descriptor_set) != VK_SUCCESS) {
+        texture->descriptor_set = VK_NULL_HANDLE;
+        DestroyTexture(texture);
+        delete texture;
+        return nullptr;
+    }
 
-    VkCommandBuffer cmd;
-    vkAllocateCommandBuffers(m_config.device, &cmd_alloc_info, &cmd);
+    // Update descriptor set
+    VkDescriptorImageInfo image_desc_info{};
+    image_desc_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    image_desc_info.imageView = texture->view;
+    image_desc_info.sampler = texture->sampler;
 
-    VkCommandBufferBeginInfo begin_info{};
-    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    vkBeginCommandBuffer(cmd, &begin_info);
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_bindless ? m_bindless_set : texture->descriptor_set;
+    write.dstBinding = 0;
+    write.dstArrayElement = m_bindless ? texture->slot : 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.descriptorCount = 1;
+    write.pImageInfo = &image_desc_info;
+
+    vkUpdateDescriptorSets(m_config.device, 1, &write, 0, nullptr);
+
+    return texture;
+}
+
+bool RenderInterface_VK::RecordTextureUpload(TextureData* texture, const StagingBuffer& staging)
+{
+    // Record the copy into this frame's shared upload batch
+    UploadContext* upload = BeginUpload();
+    if (!upload) {
+        return false;
+    }
+    VkCommandBuffer cmd = upload->cmd;
 
     // Transition image to transfer destination
     VkImageMemoryBarrier barrier{};
@@ -576,10 +1376,10 @@ Rml::TextureHandle RenderInterface_VK::GenerateTexture(Rml::Span<const Rml::byte
     region.imageSubresource.baseArrayLayer = 0;
     region.imageSubresource.layerCount = 1;
     region.imageOffset = {0, 0, 0};
-    region.imageExtent = {static_cast<uint32_t>(source_dimensions.x),
-                          static_cast<uint32_t>(source_dimensions.y), 1};
+    region.imageExtent = {static_cast<uint32_t>(texture->dimensions.x),
+                          static_cast<uint32_t>(texture->dimensions.y), 1};
 
-    vkCmdCopyBufferToImage(cmd, staging_buffer, texture->image,
+    vkCmdCopyBufferToImage(cmd, staging.buffer, texture->image,
                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 
     // Transition image to shader read
@@ -591,76 +1391,121 @@ Rml::TextureHandle RenderInterface_VK::GenerateTexture(Rml::Span<const Rml::byte
     vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
                          0, 0, nullptr, 0, nullptr, 1, &barrier);
 
-    vkEndCommandBuffer(cmd);
+    // The staging buffer is released once the batch's fence has signaled
+    upload->staging.push_back(staging);
+    texture->upload_serial = upload->serial;
+    return true;
+}
 
-    // Submit and wait
-    VkSubmitInfo submit_info{};
-    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit_info.commandBufferCount = 1;
-    submit_info.pCommandBuffers = &cmd;
+void RenderInterface_VK::DecodeWorker()
+{
+    for (;;) {
+        DecodeJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_decode_mutex);
+            m_decode_cv.wait(lock, [this] { return m_decode_stop || !m_decode_jobs.empty(); });
+            if (m_decode_stop) return;
+            job = std::move(m_decode_jobs.front());
+            m_decode_jobs.pop_front();
+        }
 
-    vkQueueSubmit(m_config.graphics_queue, 1, &submit_info, VK_NULL_HANDLE);
-    vkQueueWaitIdle(m_config.graphics_queue);
+        int width, height, channels;
+        unsigned char* image_data = stbi_load_from_memory(
+            job.file_data.data(), static_cast<int>(job.file_data.size()),
+            &width, &height, &channels, 4  // Force RGBA output
+        );
 
-    vkDestroyCommandPool(m_config.device, cmd_pool, nullptr);
-    DestroyBuffer(staging_buffer, staging_memory);
+        job.decoded = image_data && width == job.dimensions.x && height == job.dimensions.y;
+        if (job.decoded) {
+            memcpy(job.staging.allocation.mapped, image_data, static_cast<size_t>(width) * height * 4);
+        }
+        if (image_data) {
+            stbi_image_free(image_data);
+        }
 
-    // Create image view
-    VkImageViewCreateInfo view_info{};
-    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    view_info.image = texture->image;
-    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    view_info.format = VK_FORMAT_R8G8B8A8_UNORM;
-    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    view_info.subresourceRange.baseMipLevel = 0;
-    view_info.subresourceRange.levelCount = 1;
-    view_info.subresourceRange.baseArrayLayer = 0;
-    view_info.subresourceRange.layerCount = 1;
+        job.file_data.clear();
+        job.file_data.shrink_to_fit();
 
-    if (vkCreateImageView(m_config.device, &view_info, nullptr, &texture->view) != VK_SUCCESS) {
-        vkFreeMemory(m_config.device, texture->memory, nullptr);
-        vkDestroyImage(m_config.device, texture->image, nullptr);
-        delete texture;
-        return 0;
+        std::lock_guard<std::mutex> lock(m_decode_mutex);
+        m_decode_results.push_back(std::move(job));
     }
+}
 
-    texture->sampler = m_sampler;
+void RenderInterface_VK::ProcessDecodedTextures()
+{
+    std::vector<DecodeJob> results;
+    {
+        std::lock_guard<std::mutex> lock(m_decode_mutex);
+        if (m_decode_results.empty()) return;
+        results.swap(m_decode_results);
+    }
 
-    // Allocate descriptor set for this texture
-    VkDescriptorSetAllocateInfo desc_alloc_info{};
-    desc_alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    desc_alloc_info.descriptorPool = m_descriptor_pool;
-    desc_alloc_info.descriptorSetCount = 1;
-    desc_alloc_info.pSetLayouts = &m_texture_set_layout;
+    for (DecodeJob& job : results) {
+        // Released while decoding - the texture itself already went to the garbage slots
+        auto it = m_textures.find(job.handle);
+        if (it == m_textures.end()) {
+            DestroyBuffer(job.staging.buffer, job.staging.allocation);
+            continue;
+        }
 
-    if (vkAllocateDescriptorSets(m_config.device, &desc_alloc_info, &texture->descriptor_set) != VK_SUCCESS) {
-        vkDestroyImageView(m_config.device, texture->view, nullptr);
-        vkFreeMemory(m_config.device, texture->memory, nullptr);
-        vkDestroyImage(m_config.device, texture->image, nullptr);
-        delete texture;
-        return 0;
-    }
+        TextureData* texture = it->second;
+        texture->pending = false;
 
-    // Update descriptor set
-    VkDescriptorImageInfo image_desc_info{};
-    image_desc_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    image_desc_info.imageView = texture->view;
-    image_desc_info.sampler = texture->sampler;
+        // The header parsed but the pixels didn't, or not at the size it gave.
+        // The handle is already RmlUi's, so the texture stays, drawn as white.
+        if (!job.decoded) {
+            Rml::Log::Message(Rml::Log::LT_WARNING, "Failed to decode texture: %s", job.source.c_str());
+            DestroyBuffer(job.staging.buffer, job.staging.allocation);
+            texture->failed = true;
+            continue;
+        }
+
+        if (!RecordTextureUpload(texture, job.staging)) {
+            Rml::Log::Message(Rml::Log::LT_WARNING, "Failed to upload texture: %s", job.source.c_str());
+            DestroyBuffer(job.staging.buffer, job.staging.allocation);
+            texture->failed = true;
+            continue;
+        }
+
+        Rml::Log::Message(Rml::Log::LT_INFO, "Loaded texture: %s (%dx%d)",
+                          job.source.c_str(), job.dimensions.x, job.dimensions.y);
+    }
+}
 
-    VkWriteDescriptorSet write{};
-    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    write.dstSet = texture->descriptor_set;
-    write.dstBinding = 0;
-    write.dstArrayElement = 0;
-    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    write.descriptorCount = 1;
-    write.pImageInfo = &image_desc_info;
+void RenderInterface_VK::StartDecodeWorkers()
+{
+    unsigned int count = std::thread::hardware_concurrency();
+    count = count > 2 ? count - 1 : 1;
+    if (count > MAX_DECODE_WORKERS) count = MAX_DECODE_WORKERS;
 
-    vkUpdateDescriptorSets(m_config.device, 1, &write, 0, nullptr);
+    m_decode_stop = false;
+    for (unsigned int i = 0; i < count; ++i) {
+        m_decode_workers.emplace_back(&RenderInterface_VK::DecodeWorker, this);
+    }
+}
 
-    Rml::TextureHandle handle = m_next_texture_handle++;
-    m_textures[handle] = texture;
-    return handle;
+void RenderInterface_VK::StopDecodeWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_decode_mutex);
+        m_decode_stop = true;
+    }
+    m_decode_cv.notify_all();
+
+    for (std::thread& worker : m_decode_workers) {
+        worker.join();
+    }
+    m_decode_workers.clear();
+
+    // Staging memory of jobs that never made it to an upload
+    for (DecodeJob& job : m_decode_jobs) {
+        DestroyBuffer(job.staging.buffer, job.staging.allocation);
+    }
+    for (DecodeJob& job : m_decode_results) {
+        DestroyBuffer(job.staging.buffer, job.staging.allocation);
+    }
+    m_decode_jobs.clear();
+    m_decode_results.clear();
 }
 
 void RenderInterface_VK::ReleaseTexture(Rml::TextureHandle texture_handle)
@@ -670,8 +1515,8 @@ void RenderInterface_VK::ReleaseTexture(Rml::TextureHandle texture_handle)
 
     TextureData* texture = it->second;
 
-    // Don't delete the white texture - it's needed for the lifetime of the renderer
-    if (texture == m_white_texture) {
+    // Don't delete the built-in textures - they're needed for the lifetime of the renderer
+    if (texture == m_white_texture || texture == m_placeholder_texture) {
         return;
     }
 
@@ -703,6 +1548,153 @@ void RenderInterface_VK::SetTransform(const Rml::Matrix4f* transform)
         m_transform = Rml::Matrix4f::Identity();
         m_transform_enabled = false;
     }
+    UpdateMvp();
+}
+
+void RenderInterface_VK::UpdateMvp()
+{
+    Rml::Matrix4f mvp = m_transform_enabled ? m_projection * m_transform : m_projection;
+
+    // RmlUI resets the transform around every transformed element; only a real
+    // change starts a new entry for the draws that follow.
+    if (m_frame_transforms.empty() || mvp != m_mvp) {
+        m_mvp = mvp;
+        m_frame_transforms.push_back(mvp);
+        HashFrameData(mvp.data(), sizeof(float) * 16);
+    }
+}
+
+void RenderInterface_VK::SetViewport()
+{
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(m_viewport_width);
+    viewport.height = static_cast<float>(m_viewport_height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    if (m_config.cmd_set_viewport) {
+        m_config.cmd_set_viewport(m_current_cmd, 0, 1, &viewport);
+    } else {
+        vkCmdSetViewport(m_current_cmd, 0, 1, &viewport);
+    }
+}
+
+void RenderInterface_VK::BindPipeline(VkPipeline pipeline)
+{
+    if (m_bound.pipeline == pipeline) {
+        m_frame_stats.pipeline_binds_skipped++;
+        return;
+    }
+
+    auto bind_pipeline = m_config.cmd_bind_pipeline ? m_config.cmd_bind_pipeline : vkCmdBindPipeline;
+    bind_pipeline(m_current_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    m_bound.pipeline = pipeline;
+    m_frame_stats.pipeline_binds++;
+}
+
+void RenderInterface_VK::BindDescriptorSet(VkDescriptorSet descriptor_set)
+{
+    // Both pipelines share m_pipeline_layout, so the set survives pipeline switches
+    if (m_bound.descriptor_set == descriptor_set) {
+        m_frame_stats.descriptor_binds_skipped++;
+        return;
+    }
+
+    auto bind_desc = m_config.cmd_bind_descriptor_sets ? m_config.cmd_bind_descriptor_sets
+                                                       : vkCmdBindDescriptorSets;
+    bind_desc(m_current_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline_layout,
+              0, 1, &descriptor_set, 0, nullptr);
+    m_bound.descriptor_set = descriptor_set;
+    m_frame_stats.descriptor_binds++;
+}
+
+void RenderInterface_VK::BindGeometryBuffer(VkBuffer buffer)
+{
+    if (m_bound.geometry_buffer == buffer) {
+        m_frame_stats.buffer_binds_skipped++;
+        return;
+    }
+
+    VkDeviceSize offset = 0;
+    auto bind_vb = m_config.cmd_bind_vertex_buffers ? m_config.cmd_bind_vertex_buffers
+                                                    : vkCmdBindVertexBuffers;
+    bind_vb(m_current_cmd, 0, 1, &buffer, &offset);
+
+    auto bind_ib = m_config.cmd_bind_index_buffer ? m_config.cmd_bind_index_buffer
+                                                  : vkCmdBindIndexBuffer;
+    bind_ib(m_current_cmd, buffer, 0, VK_INDEX_TYPE_UINT32);
+
+    m_bound.geometry_buffer = buffer;
+    m_frame_stats.buffer_binds++;
+}
+
+void RenderInterface_VK::SetScissor(const VkRect2D& scissor)
+{
+    if (m_bound.scissor_valid &&
+        m_bound.scissor.offset.x == scissor.offset.x &&
+        m_bound.scissor.offset.y == scissor.offset.y &&
+        m_bound.scissor.extent.width == scissor.extent.width &&
+        m_bound.scissor.extent.height == scissor.extent.height) {
+        m_frame_stats.scissor_sets_skipped++;
+        return;
+    }
+
+    auto set_scissor = m_config.cmd_set_scissor ? m_config.cmd_set_scissor : vkCmdSetScissor;
+    set_scissor(m_current_cmd, 0, 1, &scissor);
+    m_bound.scissor = scissor;
+    m_bound.scissor_valid = true;
+    m_frame_stats.scissor_sets++;
+}
+
+void RenderInterface_VK::SetTextureIndex(uint32_t texture_index)
+{
+    if (m_bound.texture_index_valid && m_bound.texture_index == texture_index) {
+        m_frame_stats.push_constants_skipped++;
+        return;
+    }
+
+    // Overlaps the fragment stage's range, so it has to name both stages
+    auto push_const = m_config.cmd_push_constants ? m_config.cmd_push_constants : vkCmdPushConstants;
+    push_const(m_current_cmd, m_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+               offsetof(PushConstants, texture_index), sizeof(uint32_t), &texture_index);
+    m_bound.texture_index = texture_index;
+    m_bound.texture_index_valid = true;
+    m_frame_stats.push_constants++;
+}
+
+void RenderInterface_VK::PushDrawConstants(uint32_t transform, Rml::Vector2f translation)
+{
+    auto push_const = m_config.cmd_push_constants ? m_config.cmd_push_constants : vkCmdPushConstants;
+
+    // The transform and the translation are pushed as separate ranges, since
+    // the translation changes per element while the transform rarely does.
+    if (!m_bound.transform_valid ||
+        (m_bound.transform != transform &&
+         m_frame_transforms[m_bound.transform] != m_frame_transforms[transform])) {
+        push_const(m_current_cmd, m_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT,
+                   offsetof(PushConstants, transform), sizeof(float) * 16,
+                   m_frame_transforms[transform].data());
+        m_bound.transform = transform;
+        m_bound.transform_valid = true;
+        m_frame_stats.push_constants++;
+    } else {
+        m_frame_stats.push_constants_skipped++;
+    }
+
+    if (!m_bound.translation_valid ||
+        m_bound.translation[0] != translation.x || m_bound.translation[1] != translation.y) {
+        m_bound.translation[0] = translation.x;
+        m_bound.translation[1] = translation.y;
+        push_const(m_current_cmd, m_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT,
+                   offsetof(PushConstants, translation), sizeof(m_bound.translation),
+                   m_bound.translation);
+        m_bound.translation_valid = true;
+        m_frame_stats.push_constants++;
+    } else {
+        m_frame_stats.push_constants_skipped++;
+    }
 }
 
 bool RenderInterface_VK::CreateDescriptorSetLayout()
@@ -722,6 +1714,100 @@ bool RenderInterface_VK::CreateDescriptorSetLayout()
                                         &m_texture_set_layout) == VK_SUCCESS;
 }
 
+bool RenderInterface_VK::CreateBindlessDescriptors()
+{
+    // descriptor_indexing says the features were enabled; check the device
+    // has every one the array relies on before trusting it
+    VkPhysicalDeviceDescriptorIndexingFeatures indexing{};
+    indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &indexing;
+    vkGetPhysicalDeviceFeatures2(m_config.physical_device, &features);
+
+    if (!indexing.descriptorBindingPartiallyBound ||
+        !indexing.descriptorBindingSampledImageUpdateAfterBind ||
+        !indexing.descriptorBindingUpdateUnusedWhilePending ||
+        !features.features.shaderSampledImageArrayDynamicIndexing) {
+        Rml::Log::Message(Rml::Log::LT_WARNING,
+                          "Descriptor indexing features missing, using per-texture descriptor sets");
+        return false;
+    }
+
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = MAX_BINDLESS_TEXTURES;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    // Slots are filled as textures are created, while the set stays bound in
+    // frames that are still in flight. Those frames never sample a new slot,
+    // which is what UPDATE_UNUSED_WHILE_PENDING permits.
+    VkDescriptorBindingFlags binding_flags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                             VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                             VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flags_info{};
+    flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flags_info.bindingCount = 1;
+    flags_info.pBindingFlags = &binding_flags;
+
+    VkDescriptorSetLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.pNext = &flags_info;
+    layout_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layout_info.bindingCount = 1;
+    layout_info.pBindings = &binding;
+
+    if (vkCreateDescriptorSetLayout(m_config.device, &layout_info, nullptr,
+                                    &m_texture_set_layout) != VK_SUCCESS) {
+        Rml::Log::Message(Rml::Log::LT_WARNING,
+                          "Bindless texture layout unavailable, using per-texture descriptor sets");
+        m_texture_set_layout = VK_NULL_HANDLE;
+        return false;
+    }
+
+    VkDescriptorPoolSize pool_size{};
+    pool_size.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pool_size.descriptorCount = MAX_BINDLESS_TEXTURES;
+
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    pool_info.poolSizeCount = 1;
+    pool_info.pPoolSizes = &pool_size;
+    pool_info.maxSets = 1;
+
+    bool created = vkCreateDescriptorPool(m_config.device, &pool_info, nullptr,
+                                          &m_descriptor_pool) == VK_SUCCESS;
+    if (!created) {
+        m_descriptor_pool = VK_NULL_HANDLE;
+    } else {
+        VkDescriptorSetAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        alloc_info.descriptorPool = m_descriptor_pool;
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &m_texture_set_layout;
+        created = vkAllocateDescriptorSets(m_config.device, &alloc_info, &m_bindless_set) == VK_SUCCESS;
+    }
+
+    if (!created) {
+        Rml::Log::Message(Rml::Log::LT_WARNING,
+                          "Bindless texture array unavailable, using per-texture descriptor sets");
+        if (m_descriptor_pool != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(m_config.device, m_descriptor_pool, nullptr);
+            m_descriptor_pool = VK_NULL_HANDLE;
+        }
+        vkDestroyDescriptorSetLayout(m_config.device, m_texture_set_layout, nullptr);
+        m_texture_set_layout = VK_NULL_HANDLE;
+        m_bindless_set = VK_NULL_HANDLE;
+        return false;
+    }
+
+    return true;
+}
+
 bool RenderInterface_VK::CreateDescriptorPool()
 {
     VkDescriptorPoolSize pool_size{};
@@ -760,19 +1846,27 @@ bool RenderInterface_VK::CreateSampler()
 
 bool RenderInterface_VK::CreatePipeline()
 {
-    // Push constant range for transform matrix and translation
-    VkPushConstantRange push_constant_range{};
-    push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    push_constant_range.offset = 0;
-    push_constant_range.size = sizeof(PushConstants);
+    // Push constant range for transform matrix and translation. The bindless
+    // path splits off the texture index, which the fragment shader reads too.
+    VkPushConstantRange push_constant_ranges[2]{};
+    push_constant_ranges[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    push_constant_ranges[0].offset = 0;
+    push_constant_ranges[0].size = sizeof(PushConstants);
+
+    if (m_bindless) {
+        push_constant_ranges[0].size = offsetof(PushConstants, texture_index);
+        push_constant_ranges[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        push_constant_ranges[1].offset = offsetof(PushConstants, texture_index);
+        push_constant_ranges[1].size = sizeof(PushConstants) - offsetof(PushConstants, texture_index);
+    }
 
     // Pipeline layout
     VkPipelineLayoutCreateInfo layout_info{};
     layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     layout_info.setLayoutCount = 1;
     layout_info.pSetLayouts = &m_texture_set_layout;
-    layout_info.pushConstantRangeCount = 1;
-    layout_info.pPushConstantRanges = &push_constant_range;
+    layout_info.pushConstantRangeCount = m_bindless ? 2 : 1;
+    layout_info.pPushConstantRanges = push_constant_ranges;
 
     if (vkCreatePipelineLayout(m_config.device, &layout_info, nullptr, &m_pipeline_layout) != VK_SUCCESS) {
         return false;
@@ -792,8 +1886,13 @@ bool RenderInterface_VK::CreatePipeline()
 
     VkShaderModuleCreateInfo frag_info{};
     frag_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    frag_info.codeSize = rmlui_frag_spv_len;
-    frag_info.pCode = reinterpret_cast<const uint32_t*>(rmlui_frag_spv);
+    if (m_bindless) {
+        frag_info.codeSize = rmlui_bindless_frag_spv_len;
+        frag_info.pCode = reinterpret_cast<const uint32_t*>(rmlui_bindless_frag_spv);
+    } else {
+        frag_info.codeSize = rmlui_frag_spv_len;
+        frag_info.pCode = reinterpret_cast<const uint32_t*>(rmlui_frag_spv);
+    }
 
     VkShaderModule frag_module;
     if (vkCreateShaderModule(m_config.device, &frag_info, nullptr, &frag_module) != VK_SUCCESS) {
@@ -974,7 +2073,7 @@ bool RenderInterface_VK::CreatePipeline()
 }
 
 VkBuffer RenderInterface_VK::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
-                                           VkMemoryPropertyFlags properties, VkDeviceMemory& memory)
+                                           VkMemoryPropertyFlags properties, MemoryAllocation& allocation)
 {
     VkBuffer buffer;
 
@@ -991,39 +2090,21 @@ VkBuffer RenderInterface_VK::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags
     VkMemoryRequirements mem_reqs;
     vkGetBufferMemoryRequirements(m_config.device, buffer, &mem_reqs);
 
-    VkMemoryAllocateInfo alloc_info{};
-    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    alloc_info.allocationSize = mem_reqs.size;
-    alloc_info.memoryTypeIndex = FindMemoryType(mem_reqs.memoryTypeBits, properties);
-
-    if (vkAllocateMemory(m_config.device, &alloc_info, nullptr, &memory) != VK_SUCCESS) {
+    if (!m_memory_heap.Allocate(mem_reqs, properties, MemoryKind::Buffer, allocation)) {
         vkDestroyBuffer(m_config.device, buffer, nullptr);
         return VK_NULL_HANDLE;
     }
 
-    vkBindBufferMemory(m_config.device, buffer, memory, 0);
+    vkBindBufferMemory(m_config.device, buffer, allocation.memory, allocation.offset);
     return buffer;
 }
 
-uint32_t RenderInterface_VK::FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties)
-{
-    for (uint32_t i = 0; i < m_config.memory_properties.memoryTypeCount; i++) {
-        if ((type_filter & (1 << i)) &&
-            (m_config.memory_properties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-    return 0;
-}
-
-void RenderInterface_VK::DestroyBuffer(VkBuffer buffer, VkDeviceMemory memory)
+void RenderInterface_VK::DestroyBuffer(VkBuffer buffer, MemoryAllocation& allocation)
 {
     if (buffer != VK_NULL_HANDLE) {
         vkDestroyBuffer(m_config.device, buffer, nullptr);
     }
-    if (memory != VK_NULL_HANDLE) {
-        vkFreeMemory(m_config.device, memory, nullptr);
-    }
+    m_memory_heap.Free(allocation);
 }
 
 void RenderInterface_VK::DestroyTexture(TextureData* texture)
@@ -1037,9 +2118,332 @@ void RenderInterface_VK::DestroyTexture(TextureData* texture)
     if (texture->image != VK_NULL_HANDLE) {
         vkDestroyImage(m_config.device, texture->image, nullptr);
     }
-    if (texture->memory != VK_NULL_HANDLE) {
-        vkFreeMemory(m_config.device, texture->memory, nullptr);
+    m_memory_heap.Free(texture->allocation);
+
+    // The slot is only handed out again once nothing in flight can sample it,
+    // which holds since textures are destroyed through the garbage slots.
+    if (texture->slot != NO_TEXTURE_SLOT) {
+        m_free_texture_slots.push_back(texture->slot);
+        texture->slot = NO_TEXTURE_SLOT;
+    }
+}
+
+bool RenderInterface_VK::AllocateTextureSlot(uint32_t& slot)
+{
+    if (!m_free_texture_slots.empty()) {
+        slot = m_free_texture_slots.back();
+        m_free_texture_slots.pop_back();
+        return true;
+    }
+
+    if (m_next_texture_slot >= MAX_BINDLESS_TEXTURES) {
+        Rml::Log::Message(Rml::Log::LT_ERROR, "Bindless texture array is full (%u textures)",
+                          MAX_BINDLESS_TEXTURES);
+        return false;
+    }
+
+    slot = m_next_texture_slot++;
+    return true;
+}
+
+bool RenderInterface_VK::ArenaAllocate(VkDeviceSize size, ArenaBlock& block)
+{
+    size = AlignUp(size, ARENA_ALIGNMENT);
+
+    // Geometry bigger than a chunk gets a chunk of its own
+    if (size > ARENA_CHUNK_SIZE) {
+        int index = CreateArenaChunk(size, true);
+        if (index < 0 || !AllocateFromChunk(m_arena_chunks[index], size, block.offset)) {
+            return false;
+        }
+        block.chunk = static_cast<uint32_t>(index);
+        block.size = size;
+        return true;
+    }
+
+    // Next-fit across the shared chunks, starting where the last allocation landed
+    const uint32_t count = static_cast<uint32_t>(m_arena_chunks.size());
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t index = (m_arena_chunk_cursor + i) % count;
+        ArenaChunk& chunk = m_arena_chunks[index];
+        if (chunk.buffer == VK_NULL_HANDLE || chunk.dedicated) continue;
+
+        if (AllocateFromChunk(chunk, size, block.offset)) {
+            block.chunk = index;
+            block.size = size;
+            m_arena_chunk_cursor = index;
+            return true;
+        }
+    }
+
+    int index = CreateArenaChunk(ARENA_CHUNK_SIZE, false);
+    if (index < 0 || !AllocateFromChunk(m_arena_chunks[index], size, block.offset)) {
+        return false;
+    }
+
+    block.chunk = static_cast<uint32_t>(index);
+    block.size = size;
+    m_arena_chunk_cursor = block.chunk;
+    return true;
+}
+
+bool RenderInterface_VK::AllocateFromChunk(ArenaChunk& chunk, VkDeviceSize size, VkDeviceSize& offset)
+{
+    // Search forward from the cursor first, then wrap around to the start
+    auto split = chunk.free_ranges.lower_bound(chunk.cursor);
+    auto take = [&](std::map<VkDeviceSize, VkDeviceSize>::iterator it) {
+        offset = it->first;
+        VkDeviceSize remaining = it->second - size;
+        chunk.free_ranges.erase(it);
+        if (remaining > 0) {
+            chunk.free_ranges.emplace(offset + size, remaining);
+        }
+        chunk.cursor = offset + size;
+        chunk.used += size;
+    };
+
+    for (auto it = split; it != chunk.free_ranges.end(); ++it) {
+        if (it->second >= size) {
+            take(it);
+            return true;
+        }
+    }
+    for (auto it = chunk.free_ranges.begin(); it != split; ++it) {
+        if (it->second >= size) {
+            take(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void RenderInterface_VK::ArenaFree(const ArenaBlock& block)
+{
+    if (block.chunk >= m_arena_chunks.size()) return;
+
+    ArenaChunk& chunk = m_arena_chunks[block.chunk];
+    if (chunk.buffer == VK_NULL_HANDLE) return;
+
+    chunk.used -= block.size;
+
+    if (chunk.dedicated && chunk.used == 0) {
+        DestroyArenaChunk(chunk);
+        return;
+    }
+
+    // Insert the range and merge with its neighbours
+    auto it = chunk.free_ranges.emplace(block.offset, block.size).first;
+
+    auto next = std::next(it);
+    if (next != chunk.free_ranges.end() && it->first + it->second == next->first) {
+        it->second += next->second;
+        chunk.free_ranges.erase(next);
+    }
+
+    if (it != chunk.free_ranges.begin()) {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second == it->first) {
+            prev->second += it->second;
+            chunk.free_ranges.erase(it);
+        }
+    }
+}
+
+int RenderInterface_VK::CreateArenaChunk(VkDeviceSize size, bool dedicated)
+{
+    ArenaChunk chunk{};
+    chunk.size = size;
+    chunk.dedicated = dedicated;
+    chunk.buffer = CreateBuffer(
+        size,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        chunk.allocation
+    );
+
+    if (chunk.buffer == VK_NULL_HANDLE) {
+        return -1;
+    }
+
+    // Host-visible heap memory is persistently mapped
+    chunk.free_ranges.emplace(0, size);
+
+    // Reuse the slot of a destroyed dedicated chunk if there is one
+    for (size_t i = 0; i < m_arena_chunks.size(); ++i) {
+        if (m_arena_chunks[i].buffer == VK_NULL_HANDLE) {
+            m_arena_chunks[i] = std::move(chunk);
+            return static_cast<int>(i);
+        }
+    }
+
+    m_arena_chunks.push_back(std::move(chunk));
+    return static_cast<int>(m_arena_chunks.size() - 1);
+}
+
+void RenderInterface_VK::DestroyArenaChunk(ArenaChunk& chunk)
+{
+    if (chunk.buffer == VK_NULL_HANDLE) return;
+
+    DestroyBuffer(chunk.buffer, chunk.allocation);
+    chunk = ArenaChunk{};
+}
+
+void RenderInterface_VK::DestroyArena()
+{
+    for (ArenaChunk& chunk : m_arena_chunks) {
+        DestroyArenaChunk(chunk);
+    }
+    m_arena_chunks.clear();
+    m_arena_chunk_cursor = 0;
+}
+
+RenderInterface_VK::UploadContext* RenderInterface_VK::BeginUpload()
+{
+    if (m_recording_upload >= 0) {
+        return &m_upload_contexts[m_recording_upload];
+    }
+
+    // Reuse an idle context, or one whose batch has completed in the meantime
+    RetireUploads();
+
+    int index = -1;
+    for (size_t i = 0; i < m_upload_contexts.size(); ++i) {
+        if (!m_upload_contexts[i].in_flight) {
+            index = static_cast<int>(i);
+            break;
+        }
+    }
+
+    if (index < 0) {
+        UploadContext context{};
+
+        VkCommandPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.queueFamilyIndex = m_config.queue_family_index;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        if (vkCreateCommandPool(m_config.device, &pool_info, nullptr, &context.pool) != VK_SUCCESS) {
+            Rml::Log::Message(Rml::Log::LT_ERROR, "Failed to create upload command pool");
+            return nullptr;
+        }
+
+        VkCommandBufferAllocateInfo cmd_alloc_info{};
+        cmd_alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        cmd_alloc_info.commandPool = context.pool;
+        cmd_alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        cmd_alloc_info.commandBufferCount = 1;
+
+        VkFenceCreateInfo fence_info{};
+        fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        VkSemaphoreCreateInfo semaphore_info{};
+        semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        if (vkAllocateCommandBuffers(m_config.device, &cmd_alloc_info, &context.cmd) != VK_SUCCESS ||
+            vkCreateFence(m_config.device, &fence_info, nullptr, &context.fence) != VK_SUCCESS ||
+            vkCreateSemaphore(m_config.device, &semaphore_info, nullptr, &context.semaphore) != VK_SUCCESS) {
+            vkDestroyFence(m_config.device, context.fence, nullptr);
+            vkDestroyCommandPool(m_config.device, context.pool, nullptr);
+            Rml::Log::Message(Rml::Log::LT_ERROR, "Failed to create upload command buffer");
+            return nullptr;
+        }
+
+        m_upload_contexts.push_back(std::move(context));
+        index = static_cast<int>(m_upload_contexts.size() - 1);
+    }
+
+    UploadContext& context = m_upload_contexts[index];
+    vkResetCommandPool(m_config.device, context.pool, 0);
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(context.cmd, &begin_info);
+
+    context.serial = m_next_upload_serial++;
+    m_recording_upload = index;
+    return &context;
+}
+
+void RenderInterface_VK::FlushUploads()
+{
+    if (m_recording_upload < 0) return;
+
+    UploadContext& context = m_upload_contexts[m_recording_upload];
+    m_recording_upload = -1;
+
+    vkEndCommandBuffer(context.cmd);
+
+    VkSubmitInfo submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &context.cmd;
+
+    // A binary semaphore has to be waited on before it is signaled again. If the
+    // engine never took the last one (uploads before its first frame), this batch
+    // consumes it and the engine waits on this batch's instead.
+    VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    if (m_upload_semaphore != VK_NULL_HANDLE) {
+        submit_info.waitSemaphoreCount = 1;
+        submit_info.pWaitSemaphores = &m_upload_semaphore;
+        submit_info.pWaitDstStageMask = &wait_stage;
+    }
+    if (m_config.upload_semaphore) {
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &context.semaphore;
+    }
+
+    if (vkQueueSubmit(m_config.graphics_queue, 1, &submit_info, context.fence) != VK_SUCCESS) {
+        // Nothing will signal the fence; treat the batch as done so it doesn't pin memory
+        Rml::Log::Message(Rml::Log::LT_ERROR, "Failed to submit texture uploads");
+        for (StagingBuffer& staging : context.staging) {
+            DestroyBuffer(staging.buffer, staging.allocation);
+        }
+        context.staging.clear();
+        m_completed_upload_serial = context.serial;
+        return;
+    }
+    context.in_flight = true;
+    m_upload_semaphore = m_config.upload_semaphore ? context.semaphore : VK_NULL_HANDLE;
+}
+
+void RenderInterface_VK::RetireUploads()
+{
+    for (UploadContext& context : m_upload_contexts) {
+        if (!context.in_flight) continue;
+        if (vkGetFenceStatus(m_config.device, context.fence) != VK_SUCCESS) continue;
+
+        vkResetFences(m_config.device, 1, &context.fence);
+        for (StagingBuffer& staging : context.staging) {
+            DestroyBuffer(staging.buffer, staging.allocation);
+        }
+        context.staging.clear();
+        context.in_flight = false;
+
+        if (context.serial > m_completed_upload_serial) {
+            m_completed_upload_serial = context.serial;
+        }
+    }
+}
+
+void RenderInterface_VK::DestroyUploadContexts()
+{
+    // Callers have already waited for the device to go idle
+    for (UploadContext& context : m_upload_contexts) {
+        if (m_recording_upload >= 0 && &context == &m_upload_contexts[m_recording_upload]) {
+            vkEndCommandBuffer(context.cmd);
+        }
+        for (StagingBuffer& staging : context.staging) {
+            DestroyBuffer(staging.buffer, staging.allocation);
+        }
+        vkDestroySemaphore(m_config.device, context.semaphore, nullptr);
+        vkDestroyFence(m_config.device, context.fence, nullptr);
+        vkDestroyCommandPool(m_config.device, context.pool, nullptr);
     }
+    m_upload_contexts.clear();
+    m_recording_upload = -1;
+    m_upload_semaphore = VK_NULL_HANDLE;
+    m_completed_upload_serial = m_next_upload_serial - 1;
 }
 
 } // namespace Tatoosh
@@ -10,8 +10,16 @@
 
 #include <RmlUi/Core/RenderInterface.h>
 #include <vulkan/vulkan.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <unordered_map>
+#include "memory_heap.h"
+#include "../types/frame_update.h"
+#include "../types/render_stats.h"
 
 // Forward declaration for vkQuake types
 struct cb_context_s;
@@ -44,6 +52,28 @@ struct VulkanConfig {
     PFN_vkCmdPushConstants cmd_push_constants;
     PFN_vkCmdSetScissor cmd_set_scissor;
     PFN_vkCmdSetViewport cmd_set_viewport;
+
+    // Nonzero if the device was created with descriptor indexing enabled
+    // (partially bound, update-after-bind sampled images, update unused while
+    // pending, and shaderSampledImageArrayDynamicIndexing). Selects the
+    // bindless texture path.
+    int descriptor_indexing;
+
+    // Nonzero if the engine begins the UI subpass with
+    // VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. The UI is then recorded into
+    // secondary command buffers, and an unchanged frame replays the last one.
+    int secondary_command_buffers;
+
+    // Nonzero if the engine can begin the UI pass with LOAD_OP_LOAD on the
+    // persistent UI image (color attachment 0). A frame that changes only a few
+    // small regions then clears and redraws just those. Ignored with
+    // secondary_command_buffers.
+    int partial_redraw;
+
+    // Nonzero if the engine's next frame submit waits on GetUploadSemaphore().
+    // Without it, textures uploaded at EndFrame are only safe to sample because
+    // the engine submits its frame to graphics_queue after EndFrame returns.
+    int upload_semaphore;
 };
 
 class RenderInterface_VK : public Rml::RenderInterface {
@@ -59,16 +89,35 @@ public:
     // Reinitialize with new render pass (preserves geometry/textures)
     bool Reinitialize(const VulkanConfig& config);
 
-    // Frame management - call these around RmlUI rendering
+    // Frame management - call these around RmlUI rendering.
+    // BeginFrame picks up images decoded in the background; EndFrame records
+    // the frame's draws and submits the texture uploads batched since the last flush.
     void BeginFrame(VkCommandBuffer cmd, int width, int height);
     void EndFrame();
 
+    // Semaphore signaled by the uploads EndFrame submitted, VK_NULL_HANDLE if
+    // there were none (or upload_semaphore is off). Taking it hands the wait to
+    // the caller, who must wait on it in its next submit.
+    VkSemaphore TakeUploadSemaphore();
+
     // Garbage collection - call after GPU fence wait to safely destroy resources
     void CollectGarbage();
 
+    // Device memory usage of the UI heap
+    const MemoryHeap& GetMemoryHeap() const { return m_memory_heap; }
+
+    // Command counters of the last completed frame
+    const ui_render_stats_t& GetFrameStats() const { return m_last_frame_stats; }
+
     // Set the active command buffer (from vkQuake's cb_context_t)
     void SetCommandBuffer(VkCommandBuffer cmd);
 
+    // After RmlUI has rendered, before SetCommandBuffer: compare the frame with
+    // the last recorded one. UNCHANGED keeps the previous UI image, PARTIAL
+    // redraws only GetDirtyRects() on top of it, FULL clears and redraws.
+    ui_frame_update_t EvaluateFrame();
+    const std::vector<VkRect2D>& GetDirtyRects() const { return m_dirty_rects; }
+
     // -- Inherited from Rml::RenderInterface --
 
     Rml::CompiledGeometryHandle CompileGeometry(Rml::Span<const Rml::Vertex> vertices,
@@ -89,13 +138,76 @@ public:
     void SetTransform(const Rml::Matrix4f* transform) override;
 
 private:
-    // Internal geometry data
+    // A range of the geometry arena owned by one piece of geometry
+    struct ArenaBlock {
+        uint32_t chunk;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+    };
+
+    // One persistently mapped, host-visible buffer that geometry is
+    // sub-allocated from. Free space is kept as offset -> size ranges.
+    struct ArenaChunk {
+        VkBuffer buffer;
+        MemoryAllocation allocation;
+        VkDeviceSize size;
+        VkDeviceSize cursor;      // Next-fit position, allocations walk the chunk like a ring
+        VkDeviceSize used;
+        bool dedicated;           // Sized for a single oversized geometry, freed when empty
+        std::map<VkDeviceSize, VkDeviceSize> free_ranges;
+    };
+
+    // Internal geometry data - vertices followed by indices in one arena block.
+    // Drawn with the whole chunk bound, so the block is addressed in elements.
     struct GeometryData {
-        VkBuffer vertex_buffer;
-        VkBuffer index_buffer;
-        VkDeviceMemory vertex_memory;
-        VkDeviceMemory index_memory;
+        ArenaBlock block;
+        VkBuffer buffer;
+        uint32_t first_index;
+        int32_t base_vertex;
         int num_indices;
+        Rml::Vector2f bounds_min;   // Untransformed vertex bounds
+        Rml::Vector2f bounds_max;
+        uint64_t id;                // Compile handle, never reused; 0 for a merged batch
+        // CPU copy of small geometry, so it can be merged into a batch without
+        // reading back from the write-combined arena. Empty for large geometry.
+        std::vector<Rml::Vertex> vertices;
+        std::vector<int> indices;
+    };
+
+    // A RenderGeometry call, held back until the draws around it are known
+    struct DrawCommand {
+        GeometryData* geometry;
+        uint32_t transform;       // Index into m_frame_transforms
+        Rml::Vector2f translation;
+        VkPipeline pipeline;
+        VkDescriptorSet descriptor_set;
+        uint32_t texture_index;
+        VkRect2D scissor;
+        VkRect2D bounds;          // Pixels covered, within the scissor (partial redraw only)
+    };
+
+    // What a draw contributed to the UI image, kept across frames to find the
+    // regions that changed. Equal keys mean identical inputs.
+    struct DrawRecord {
+        uint64_t key;
+        VkRect2D bounds;
+    };
+
+    // A run of draws merged into one arena block, kept while the run recurs.
+    // The key hashes each draw's geometry id and translation in order.
+    struct MergedBatch {
+        GeometryData* geometry;
+        uint64_t last_used;       // m_collect_count when last drawn
+    };
+
+    // Host-visible buffer that a cached recording writes its merged batches to,
+    // so replays don't depend on batches the cache may have evicted since.
+    struct StreamBuffer {
+        VkBuffer buffer;
+        MemoryAllocation allocation;
+        VkDeviceSize size;
+        VkDeviceSize cursor;
+        VkDeviceSize demand;      // Bytes asked for this round, including batches that did not fit
     };
 
     // Internal texture data
@@ -103,35 +215,157 @@ private:
         VkImage image;
         VkImageView view;
         VkSampler sampler;
-        VkDeviceMemory memory;
-        VkDescriptorSet descriptor_set;
+        MemoryAllocation allocation;
+        VkDescriptorSet descriptor_set;   // Per-texture path only
+        uint32_t slot;                    // Bindless path only: index into the texture array
         Rml::Vector2i dimensions;
+        uint64_t upload_serial;   // Upload batch that fills the image
+        bool pending;             // Still decoding - draws as the placeholder
+        bool failed;              // Decode or upload failed - draws as the white texture
     };
 
-    // Push constant data for vertex shader
+    struct StagingBuffer {
+        VkBuffer buffer;
+        MemoryAllocation allocation;
+    };
+
+    // A recyclable command buffer that batches texture uploads. Each submitted
+    // batch gets the next serial; a serial is complete once its fence signals.
+    struct UploadContext {
+        VkCommandPool pool;
+        VkCommandBuffer cmd;
+        VkFence fence;
+        VkSemaphore semaphore;    // Signaled by the submit if upload_semaphore is set
+        uint64_t serial;
+        bool in_flight;
+        std::vector<StagingBuffer> staging;
+    };
+
+    // Image file handed to a decode worker. The worker decodes into the
+    // mapped staging buffer and passes the job back to the main thread.
+    struct DecodeJob {
+        Rml::TextureHandle handle;
+        Rml::String source;
+        std::vector<Rml::byte> file_data;
+        StagingBuffer staging;
+        Rml::Vector2i dimensions;
+        bool decoded;
+    };
+
+    // Push constant data. texture_index sits in the vertex shader's padding and
+    // is only read by the bindless fragment shader.
     struct PushConstants {
         float transform[16];
         float translation[2];
-        float padding[2];
+        uint32_t texture_index;
+        float padding;
+    };
+
+    // A secondary command buffer holding one recorded UI frame, together with
+    // the batch data its merged draws read
+    struct CachedRecording {
+        VkCommandBuffer cmd;
+        StreamBuffer stream;
+        uint64_t last_used;       // m_collect_count when last executed
     };
 
+    // What is currently bound on m_current_cmd. Reset whenever recording starts
+    // on a command buffer, since its state is unknown to us at that point.
+    struct BoundState {
+        VkPipeline pipeline;
+        VkDescriptorSet descriptor_set;
+        VkBuffer geometry_buffer;
+        VkRect2D scissor;
+        bool scissor_valid;
+        bool transform_valid;
+        bool translation_valid;
+        bool texture_index_valid;
+        uint32_t transform;
+        float translation[2];
+        uint32_t texture_index;
+    };
+
+    // State tracking - each only records a command when the state differs
+    void BindPipeline(VkPipeline pipeline);
+    void BindDescriptorSet(VkDescriptorSet descriptor_set);
+    void SetTextureIndex(uint32_t texture_index);
+    void BindGeometryBuffer(VkBuffer buffer);
+    void SetScissor(const VkRect2D& scissor);
+    void PushDrawConstants(uint32_t transform, Rml::Vector2f translation);
+    void SetViewport();
+    void UpdateMvp();
+
+    // Draw list - consecutive draws with identical state are merged into one.
+    // Merged runs come from the batch cache unless a recording's stream is given.
+    void FlushDraws();
+    void RecordDrawList(const std::vector<DrawCommand>& draws, StreamBuffer* stream);
+    void RecordDraw(const DrawCommand& draw);
+    bool RecordMergedDraws(const DrawCommand* draws, size_t count, StreamBuffer* stream);
+    GeometryData* AcquireMergedBatch(const DrawCommand* draws, size_t count);
+    void WriteMergedBatch(const DrawCommand* draws, size_t count, uint8_t* out, VkDeviceSize index_offset);
+    void EvictMergedBatches(bool all);
+    bool CreateStreamBuffer(StreamBuffer& stream, VkDeviceSize size);
+    void ResetStreamBuffer(StreamBuffer& stream);
+
+    // Frame caching - replay the last recording while the draw stream hashes the same
+    void ResetFrameHash();
+    void HashFrameData(const void* data, size_t size);
+    static uint64_t HashBytes(uint64_t hash, const void* data, size_t size);
+    bool RecordCachedFrame();
+    int AcquireRecording();
+    void DestroyRecordings();
+
+    // Partial redraw - screen bounds of each draw, diffed against the recorded frame
+    VkRect2D ComputeDrawBounds(const GeometryData* geometry, Rml::Vector2f translation,
+                               const VkRect2D& scissor) const;
+    void AddDirtyRect(VkRect2D rect);
+    void RecordDirtyRects();
+
     // Vulkan resource creation helpers
     bool CreatePipeline();
     bool CreateDescriptorPool();
     bool CreateDescriptorSetLayout();
+    bool CreateBindlessDescriptors();
     bool CreateSampler();
     void DestroyPipelines();
 
     VkBuffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
-                          VkMemoryPropertyFlags properties, VkDeviceMemory& memory);
-    uint32_t FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties);
+                          VkMemoryPropertyFlags properties, MemoryAllocation& allocation);
 
-    void DestroyBuffer(VkBuffer buffer, VkDeviceMemory memory);
+    void DestroyBuffer(VkBuffer buffer, MemoryAllocation& allocation);
     void DestroyTexture(TextureData* texture);
 
+    // Texture creation and upload
+    TextureData* CreateTexture(Rml::Vector2i dimensions);
+    bool AllocateTextureSlot(uint32_t& slot);
+    bool RecordTextureUpload(TextureData* texture, const StagingBuffer& staging);
+
+    // Background image decoding
+    void StartDecodeWorkers();
+    void StopDecodeWorkers();
+    void DecodeWorker();
+    void ProcessDecodedTextures();
+
+    // Texture upload batching
+    UploadContext* BeginUpload();
+    void FlushUploads();
+    void RetireUploads();
+    void DestroyUploadContexts();
+
+    // Geometry arena
+    bool ArenaAllocate(VkDeviceSize size, ArenaBlock& block);
+    void ArenaFree(const ArenaBlock& block);
+    bool AllocateFromChunk(ArenaChunk& chunk, VkDeviceSize size, VkDeviceSize& offset);
+    int CreateArenaChunk(VkDeviceSize size, bool dedicated);
+    void DestroyArenaChunk(ArenaChunk& chunk);
+    void DestroyArena();
+
     // Configuration from vkQuake
     VulkanConfig m_config;
 
+    // All buffer and image memory is sub-allocated from here
+    MemoryHeap m_memory_heap;
+
     // Current frame state
     VkCommandBuffer m_current_cmd;
     int m_viewport_width;
@@ -140,6 +374,20 @@ private:
     VkRect2D m_scissor_rect;
     Rml::Matrix4f m_transform;
     bool m_transform_enabled;
+    Rml::Matrix4f m_projection;   // Rebuilt in BeginFrame
+    Rml::Matrix4f m_mvp;          // m_projection * m_transform, rebuilt when either changes
+    BoundState m_bound;
+    std::vector<DrawCommand> m_draw_list;          // Recorded at EndFrame
+    std::vector<Rml::Matrix4f> m_frame_transforms; // Every MVP used by the draw list
+    uint64_t m_frame_hash;                         // Of the draw stream since BeginFrame
+    uint64_t m_recorded_hash;                      // Of the last frame recorded, 0 if none
+    bool m_in_frame;
+    std::vector<DrawRecord> m_frame_records;       // Partial redraw: every draw since BeginFrame
+    std::vector<DrawRecord> m_recorded_records;    // ... and of the last frame recorded
+    std::vector<VkRect2D> m_dirty_rects;           // Disjoint, set by EvaluateFrame
+    bool m_partial_frame;                          // Record only the dirty rects
+    ui_render_stats_t m_frame_stats;
+    ui_render_stats_t m_last_frame_stats;
 
     // Vulkan resources
     VkPipeline m_pipeline_textured;
@@ -152,12 +400,61 @@ private:
     // Default white texture for untextured geometry
     TextureData* m_white_texture;
 
+    // Transparent stand-in for textures that are still decoding
+    TextureData* m_placeholder_texture;
+
+    // Bindless path: every texture is a slot in one update-after-bind array,
+    // selected per draw with a push constant instead of a descriptor bind.
+    static constexpr uint32_t MAX_BINDLESS_TEXTURES = 4096;  // Matches the bindless fragment shader
+    static constexpr uint32_t NO_TEXTURE_SLOT = ~0u;
+    bool m_bindless;
+    VkDescriptorSet m_bindless_set;
+    std::vector<uint32_t> m_free_texture_slots;
+    uint32_t m_next_texture_slot;
+
     // Resource tracking
     std::unordered_map<Rml::CompiledGeometryHandle, GeometryData*> m_geometries;
     std::unordered_map<Rml::TextureHandle, TextureData*> m_textures;
     Rml::CompiledGeometryHandle m_next_geometry_handle;
     Rml::TextureHandle m_next_texture_handle;
 
+    // Geometry arena chunks (indices are stable, destroyed dedicated chunks leave a free slot)
+    static constexpr VkDeviceSize ARENA_CHUNK_SIZE = 4 * 1024 * 1024;
+    std::vector<ArenaChunk> m_arena_chunks;
+    uint32_t m_arena_chunk_cursor;
+
+    // Geometry up to this many vertices keeps a CPU copy and can be merged.
+    // The copy duplicates the geometry's arena bytes in system memory, which is
+    // why larger geometry is never copied and always drawn on its own.
+    static constexpr size_t MERGE_MAX_VERTICES = 1024;
+    static constexpr VkDeviceSize STREAM_BUFFER_SIZE = 256 * 1024;
+
+    // Merged batches live in the arena and are rebuilt only when their run
+    // changes; one not drawn for this many collections is freed.
+    static constexpr uint64_t MERGED_BATCH_LIFETIME = 8;
+    std::unordered_map<uint64_t, MergedBatch> m_merged_batches;
+
+    // Past this many dirty rects they collapse into their bounding box; past
+    // this share of the screen a full clear and redraw is cheaper.
+    static constexpr size_t MAX_DIRTY_RECTS = 8;
+    static constexpr float MAX_PARTIAL_AREA = 0.5f;
+
+    // Upload batches: at most one is recording, the rest are in flight or idle
+    std::vector<UploadContext> m_upload_contexts;
+    int m_recording_upload;
+    uint64_t m_next_upload_serial;
+    uint64_t m_completed_upload_serial;
+    VkSemaphore m_upload_semaphore;   // Signaled and not yet taken by the engine
+
+    // Decode worker pool
+    static constexpr unsigned int MAX_DECODE_WORKERS = 2;
+    std::vector<std::thread> m_decode_workers;
+    std::mutex m_decode_mutex;
+    std::condition_variable m_decode_cv;
+    std::deque<DecodeJob> m_decode_jobs;
+    std::vector<DecodeJob> m_decode_results;
+    bool m_decode_stop;
+
     bool m_initialized;
 
     // Garbage collection for deferred resource destruction
@@ -165,8 +462,16 @@ private:
     // (which happens after the GPU fence for that frame has been waited on)
     static constexpr int GARBAGE_SLOTS = 2;
     int m_garbage_index;
+    // Geometry garbage returns its arena block for reuse rather than freeing driver memory.
     std::vector<GeometryData*> m_geometry_garbage[GARBAGE_SLOTS];
     std::vector<TextureData*> m_texture_garbage[GARBAGE_SLOTS];
+    uint64_t m_collect_count;
+
+    // Recorded frames, and the one an unchanged frame replays (-1 if none)
+    VkCommandPool m_recording_pool;
+    std::vector<CachedRecording> m_recordings;
+    int m_cached_recording;
+    uint64_t m_cached_hash;
 };
 
 } // namespace Tatoosh
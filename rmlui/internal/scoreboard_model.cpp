@@ -0,0 +1,192 @@
+/*
+ * Tatoosh - Scoreboard Model Implementation
+ *
+ * Maintains the ranked player list incrementally, exposing it to RmlUI
+ * as an array on the "game" data model.
+ */
+
+#include "scoreboard_model.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace Tatoosh {
+
+// Static members
+std::vector<PlayerScore> ScoreboardModel::s_rows;
+int ScoreboardModel::s_rank[MAX_SCOREBOARD_PLAYERS];
+Rml::DataModelHandle ScoreboardModel::s_model_handle;
+bool ScoreboardModel::s_initialized = false;
+
+// Approximate mid-tone of each of Quake's 14 player color rows
+static const unsigned char PLAYER_COLORS[14][3] = {
+    {143, 143, 143}, {123, 91, 55},   {139, 139, 203}, {107, 107, 15},
+    {143, 0, 0},     {175, 123, 39},  {227, 155, 63},  {219, 163, 131},
+    {163, 99, 139},  {199, 107, 139}, {203, 167, 119}, {111, 131, 79},
+    {255, 243, 27},  {75, 87, 151},
+};
+
+static std::string ColorToRgb(int color)
+{
+    const unsigned char* rgb = PLAYER_COLORS[std::clamp(color, 0, 13)];
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "rgb(%d,%d,%d)", rgb[0], rgb[1], rgb[2]);
+    return buffer;
+}
+
+void ScoreboardModel::RegisterBindings(Rml::DataModelConstructor& constructor)
+{
+    std::fill(std::begin(s_rank), std::end(s_rank), -1);
+    s_rows.reserve(MAX_SCOREBOARD_PLAYERS);
+
+    if (auto player = constructor.RegisterStruct<PlayerScore>()) {
+        player.RegisterMember("client", &PlayerScore::client);
+        player.RegisterMember("name", &PlayerScore::name);
+        player.RegisterMember("frags", &PlayerScore::frags);
+        player.RegisterMember("ping", &PlayerScore::ping);
+        player.RegisterMember("top_color", &PlayerScore::top_color);
+        player.RegisterMember("bottom_color", &PlayerScore::bottom_color);
+        player.RegisterMember("top_rgb", &PlayerScore::top_rgb);
+        player.RegisterMember("bottom_rgb", &PlayerScore::bottom_rgb);
+        player.RegisterMember("self", &PlayerScore::self);
+    }
+    constructor.RegisterArray<std::vector<PlayerScore>>();
+    constructor.Bind("players", &s_rows);
+
+    s_initialized = true;
+}
+
+void ScoreboardModel::SetModelHandle(Rml::DataModelHandle handle)
+{
+    s_model_handle = handle;
+}
+
+void ScoreboardModel::Shutdown()
+{
+    if (!s_initialized) return;
+
+    s_rows.clear();
+    std::fill(std::begin(s_rank), std::end(s_rank), -1);
+    s_model_handle = Rml::DataModelHandle();
+    s_initialized = false;
+}
+
+void ScoreboardModel::UpdatePlayer(int client, const char* name, int frags, int ping,
+                                   int top_color, int bottom_color, bool self)
+{
+    if (!s_initialized || client < 0 || client >= MAX_SCOREBOARD_PLAYERS) return;
+
+    int rank = s_rank[client];
+    bool changed = false;
+    bool rerank = false;
+
+    if (rank < 0) {
+        PlayerScore row;
+        row.client = client;
+        row.frags = frags;
+        row.top_color = -1;      // Forces the colors below to be filled in
+        row.bottom_color = -1;
+        rank = static_cast<int>(s_rows.size());
+        s_rows.push_back(std::move(row));
+        s_rank[client] = rank;
+        changed = true;
+        rerank = true;
+    }
+
+    PlayerScore& row = s_rows[rank];
+
+    if (row.frags != frags) {
+        row.frags = frags;
+        changed = true;
+        rerank = true;
+    }
+
+    // Names are compared in place, so an unchanged one is never reallocated
+    const char* new_name = name ? name : "";
+    if (row.name != new_name) {
+        row.name = new_name;
+        changed = true;
+    }
+    if (row.ping != ping) {
+        row.ping = ping;
+        changed = true;
+    }
+    if (row.self != self) {
+        row.self = self;
+        changed = true;
+    }
+    if (row.top_color != top_color) {
+        row.top_color = top_color;
+        row.top_rgb = ColorToRgb(top_color);
+        changed = true;
+    }
+    if (row.bottom_color != bottom_color) {
+        row.bottom_color = bottom_color;
+        row.bottom_rgb = ColorToRgb(bottom_color);
+        changed = true;
+    }
+
+    if (rerank) {
+        Reposition(rank);
+    }
+    if (changed) {
+        MarkDirty();
+    }
+}
+
+void ScoreboardModel::RemovePlayer(int client)
+{
+    if (!s_initialized || client < 0 || client >= MAX_SCOREBOARD_PLAYERS) return;
+
+    int rank = s_rank[client];
+    if (rank < 0) return;
+
+    s_rows.erase(s_rows.begin() + rank);
+    s_rank[client] = -1;
+    for (size_t i = rank; i < s_rows.size(); ++i) {
+        s_rank[s_rows[i].client] = static_cast<int>(i);
+    }
+    MarkDirty();
+}
+
+void ScoreboardModel::Clear()
+{
+    if (s_rows.empty()) return;
+
+    for (const PlayerScore& row : s_rows) {
+        s_rank[row.client] = -1;
+    }
+    s_rows.clear();
+    MarkDirty();
+}
+
+bool ScoreboardModel::RanksBefore(const PlayerScore& a, const PlayerScore& b)
+{
+    return a.frags != b.frags ? a.frags > b.frags : a.client < b.client;
+}
+
+void ScoreboardModel::Reposition(int rank)
+{
+    // A single insertion step: only the rows the player passes move, so a
+    // frag usually costs a swap or two rather than a sort of the whole list.
+    int last = static_cast<int>(s_rows.size()) - 1;
+    while (rank > 0 && RanksBefore(s_rows[rank], s_rows[rank - 1])) {
+        std::swap(s_rows[rank], s_rows[rank - 1]);
+        s_rank[s_rows[rank].client] = rank;
+        --rank;
+    }
+    while (rank < last && RanksBefore(s_rows[rank + 1], s_rows[rank])) {
+        std::swap(s_rows[rank], s_rows[rank + 1]);
+        s_rank[s_rows[rank].client] = rank;
+        ++rank;
+    }
+    s_rank[s_rows[rank].client] = rank;
+}
+
+void ScoreboardModel::MarkDirty()
+{
+    if (s_model_handle) {
+        s_model_handle.DirtyVariable("players");
+    }
+}
+
+} // namespace Tatoosh
@@ -0,0 +1,62 @@
+/*
+ * Tatoosh - Scoreboard Model
+ *
+ * Keeps the deathmatch player list sorted by frags for the scoreboard.
+ * Bindings are registered on the "game" data model alongside GameDataModel.
+ *
+ * Usage in RML:
+ *   <div data-for="player : players" data-class-self="player.self">
+ *     {{ player.name }} {{ player.frags }} {{ player.ping }}
+ *   </div>
+ */
+
+#ifndef TATOOSH_SCOREBOARD_MODEL_H
+#define TATOOSH_SCOREBOARD_MODEL_H
+
+#include <RmlUi/Core.h>
+#include <vector>
+#include "../types/scoreboard_state.h"
+
+namespace Tatoosh {
+
+class ScoreboardModel {
+public:
+    // Register the player list on the game data model constructor.
+    // Must be called during GameDataModel::Initialize, before GetModelHandle().
+    static void RegisterBindings(Rml::DataModelConstructor& constructor);
+
+    // Store the model handle (call after GetModelHandle in GameDataModel)
+    static void SetModelHandle(Rml::DataModelHandle handle);
+
+    // Shutdown and cleanup
+    static void Shutdown();
+
+    // Add or update one client. A frag change moves only that row to its new
+    // rank; the list is dirtied only if something actually changed.
+    static void UpdatePlayer(int client, const char* name, int frags, int ping,
+                             int top_color, int bottom_color, bool self);
+
+    // Remove a client that disconnected
+    static void RemovePlayer(int client);
+
+    // Remove every client (level change, disconnect)
+    static void Clear();
+
+private:
+    // Sort order: frags descending, then client number
+    static bool RanksBefore(const PlayerScore& a, const PlayerScore& b);
+
+    // Slide the row at rank up or down until the list is sorted again
+    static void Reposition(int rank);
+
+    static void MarkDirty();
+
+    static std::vector<PlayerScore> s_rows;          // Sorted, bound as "players"
+    static int s_rank[MAX_SCOREBOARD_PLAYERS];       // client -> index in s_rows, -1 if absent
+    static Rml::DataModelHandle s_model_handle;
+    static bool s_initialized;
+};
+
+} // namespace Tatoosh
+
+#endif // TATOOSH_SCOREBOARD_MODEL_H
@@ -0,0 +1,16 @@
+#version 460
+
+// Textured geometry, one descriptor set per texture
+
+layout(set = 0, binding = 0) uniform sampler2D tex;
+
+layout(location = 0) in vec4 in_color;
+layout(location = 1) in vec2 in_texcoord;
+
+layout(location = 0) out vec4 out_frag_color;
+
+void main()
+{
+    vec4 tex_color = texture(tex, in_texcoord);
+    out_frag_color = in_color * tex_color;
+}
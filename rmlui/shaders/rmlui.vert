@@ -0,0 +1,24 @@
+#version 460
+
+// RmlUI geometry: position in document pixels, premultiplied vertex colour
+
+layout(push_constant) uniform PushConsts {
+    mat4 mvp;
+    vec2 translate;
+    vec2 padding;    // Bindless path: texture index, read by rmlui_bindless.frag
+} push_constants;
+
+layout(location = 0) in vec2 in_position;
+layout(location = 1) in vec4 in_color;
+layout(location = 2) in vec2 in_texcoord;
+
+layout(location = 0) out vec4 out_color;
+layout(location = 1) out vec2 out_texcoord;
+
+void main()
+{
+    vec2 translated_pos = in_position + push_constants.translate;
+    gl_Position = push_constants.mvp * vec4(translated_pos, 0.0, 1.0);
+    out_color = in_color;
+    out_texcoord = in_texcoord;
+}
@@ -0,0 +1,22 @@
+#version 460
+
+// Textured geometry, bindless path: every UI texture lives in one array
+// (MAX_BINDLESS_TEXTURES in render_interface_vk.h) and the draw selects it
+// with a push constant. The index is the same for the whole draw, so dynamic
+// indexing is enough; no nonuniformEXT.
+
+layout(push_constant) uniform PushConsts {
+    layout(offset = 72) uint texture_index;
+} pc;
+
+layout(set = 0, binding = 0) uniform sampler2D textures[4096];
+
+layout(location = 0) in vec4 in_color;
+layout(location = 1) in vec2 in_texcoord;
+
+layout(location = 0) out vec4 out_frag_color;
+
+void main()
+{
+    out_frag_color = in_color * texture(textures[pc.texture_index], in_texcoord);
+}
@@ -0,0 +1,13 @@
+#version 460
+
+// Untextured geometry
+
+layout(location = 0) in vec4 in_color;
+layout(location = 1) in vec2 in_texcoord;
+
+layout(location = 0) out vec4 out_frag_color;
+
+void main()
+{
+    out_frag_color = in_color;
+}
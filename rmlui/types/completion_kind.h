@@ -0,0 +1,26 @@
+/*
+ * Tatoosh - Completion Kind Type
+ *
+ * What a name in the console completion index refers to.
+ * C-compatible enum used across the C/C++ boundary.
+ */
+
+#ifndef TATOOSH_COMPLETION_KIND_H
+#define TATOOSH_COMPLETION_KIND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Also the tie-break order when ranking completions */
+typedef enum {
+    UI_COMPLETION_COMMAND,
+    UI_COMPLETION_CVAR,
+    UI_COMPLETION_ALIAS
+} ui_completion_kind_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TATOOSH_COMPLETION_KIND_H
@@ -12,6 +12,14 @@
 
 namespace Tatoosh {
 
+// Opaque reference to a resolved cvar. Engine cvars are never freed, so a
+// reference stays valid for as long as the provider that returned it.
+struct CvarRef {
+    const void* ptr = nullptr;
+
+    explicit operator bool() const { return ptr != nullptr; }
+};
+
 // Interface for cvar operations
 // Implemented by infrastructure layer (QuakeCvarProvider)
 class ICvarProvider {
@@ -32,6 +40,13 @@ public:
 
     // Check if a cvar exists
     virtual bool Exists(const std::string& name) const = 0;
+
+    // Resolve a cvar once for repeated reads (empty if it doesn't exist)
+    virtual CvarRef Find(const char* name) const = 0;
+
+    // Read a resolved cvar without a name lookup
+    virtual float GetFloat(CvarRef cvar) const = 0;
+    virtual const char* GetString(CvarRef cvar) const = 0;
 };
 
 } // namespace Tatoosh
@@ -33,6 +33,7 @@ struct CvarBinding {
     int num_values = 0;      // For enum type
     std::vector<int> enum_values;        // Optional explicit values for enum
     std::vector<std::string> enum_labels;  // Optional display labels for enum
+    bool requires_restart = false;       // Held back until applied, then vid_restart
 };
 
 } // namespace Tatoosh
@@ -0,0 +1,34 @@
+/*
+ * Tatoosh - Frame Update Type
+ *
+ * How much of the persistent UI image a frame has to redraw.
+ * C-compatible types used across the C/C++ boundary.
+ */
+
+#ifndef TATOOSH_FRAME_UPDATE_H
+#define TATOOSH_FRAME_UPDATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Result of UI_PrepareFrame - decides how the engine runs the UI pass */
+typedef enum {
+    UI_FRAME_UNCHANGED,     /* Previous UI image is current - skip the UI pass */
+    UI_FRAME_FULL,          /* Clear and redraw the whole UI image */
+    UI_FRAME_PARTIAL        /* Load the previous image - only the dirty rectangles are redrawn */
+} ui_frame_update_t;
+
+/* Screen-space rectangle in pixels, origin top-left */
+typedef struct ui_rect_s {
+    int x;
+    int y;
+    int width;
+    int height;
+} ui_rect_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TATOOSH_FRAME_UPDATE_H
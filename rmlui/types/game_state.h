@@ -3,79 +3,159 @@
  *
  * Represents the current state of the game for UI display.
  * This is a pure data structure with no framework dependencies.
+ *
+ * Stats and flags are listed once in the field tables below; the data model
+ * bindings, change detection and debug dumps are all generated from them.
  */
 
 #ifndef TATOOSH_DOMAIN_GAME_STATE_H
 #define TATOOSH_DOMAIN_GAME_STATE_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TATOOSH_GAME_STATS_SSE2 1
+#endif
 
 namespace Tatoosh {
 
-// Game state structure that mirrors Quake's cl.stats and cl.items
+// Integer stats, mirroring cl.stats[] plus values derived from it: X(name, default)
+#define TATOOSH_GAME_STATS(X) \
+    X(health, 100)          \
+    X(armor, 0)             \
+    X(ammo, 0)              \
+    X(active_weapon, 0)     \
+    X(shells, 0)            \
+    X(nails, 0)             \
+    X(rockets, 0)           \
+    X(cells, 0)             \
+    X(monsters, 0)          \
+    X(total_monsters, 0)    \
+    X(secrets, 0)           \
+    X(total_secrets, 0)     \
+    X(armor_type, 0)        /* 0=none, 1=green, 2=yellow, 3=red */ \
+    X(time_minutes, 0)      \
+    X(time_seconds, 0)      \
+    X(face_index, 0)        /* 0-4 health tier */
+
+// Boolean flags, mostly decoded from cl.items; one bit each: X(name)
+#define TATOOSH_GAME_FLAGS(X) \
+    X(has_shotgun)          \
+    X(has_super_shotgun)    \
+    X(has_nailgun)          \
+    X(has_super_nailgun)    \
+    X(has_grenade_launcher) \
+    X(has_rocket_launcher)  \
+    X(has_lightning_gun)    \
+    X(has_key1)             /* Silver key */ \
+    X(has_key2)             /* Gold key */ \
+    X(has_invisibility)     \
+    X(has_invulnerability)  \
+    X(has_suit)             \
+    X(has_quad)             \
+    X(has_sigil1)           \
+    X(has_sigil2)           \
+    X(has_sigil3)           \
+    X(has_sigil4)           \
+    X(intermission)         \
+    X(deathmatch)           \
+    X(coop)                 \
+    X(face_pain)
+
+#define TATOOSH_GAME_FIELD_ENUM(name, ...) name,
+#define TATOOSH_GAME_FIELD_NAME(name, ...) #name,
+#define TATOOSH_GAME_STAT_DEFAULT(name, value) value,
+
+enum class GameStat : uint32_t {
+    TATOOSH_GAME_STATS(TATOOSH_GAME_FIELD_ENUM)
+    Count
+};
+
+enum class GameFlag : uint32_t {
+    TATOOSH_GAME_FLAGS(TATOOSH_GAME_FIELD_ENUM)
+    Count
+};
+
+// Binding names, indexed by GameStat / GameFlag
+inline constexpr const char* GAME_STAT_NAMES[] = { TATOOSH_GAME_STATS(TATOOSH_GAME_FIELD_NAME) };
+inline constexpr const char* GAME_FLAG_NAMES[] = { TATOOSH_GAME_FLAGS(TATOOSH_GAME_FIELD_NAME) };
+
+inline constexpr size_t GAME_STAT_COUNT = static_cast<size_t>(GameStat::Count);
+inline constexpr size_t GAME_FLAG_COUNT = static_cast<size_t>(GameFlag::Count);
+
+// Stats are compared four at a time, so the array is padded to a multiple of four
+inline constexpr size_t GAME_STAT_SLOTS = (GAME_STAT_COUNT + 3) & ~size_t(3);
+
+static_assert(GAME_STAT_SLOTS <= 32, "changed-stat mask is 32 bits");
+static_assert(GAME_FLAG_COUNT <= 32, "flags are packed into 32 bits");
+
+// Stat and flag block: plain data, cache-line aligned, cheap to copy to
+// another thread and to diff as a whole.
+struct alignas(64) GameStats {
+    int32_t values[GAME_STAT_SLOTS] = { TATOOSH_GAME_STATS(TATOOSH_GAME_STAT_DEFAULT) };
+    uint32_t flags = 0;   // Bit n is GameFlag n
+
+    int32_t& operator[](GameStat stat) { return values[static_cast<size_t>(stat)]; }
+    int32_t operator[](GameStat stat) const { return values[static_cast<size_t>(stat)]; }
+
+    bool Has(GameFlag flag) const { return (flags >> static_cast<uint32_t>(flag)) & 1u; }
+    void Set(GameFlag flag, bool value)
+    {
+        uint32_t bit = 1u << static_cast<uint32_t>(flag);
+        flags = value ? (flags | bit) : (flags & ~bit);
+    }
+};
+
+static_assert(std::is_trivially_copyable<GameStats>::value, "GameStats must stay plain data");
+
+// Which fields differ between two snapshots: bit n of stats is GameStat n,
+// bit n of flags is GameFlag n
+struct GameStatsDiff {
+    uint32_t stats;
+    uint32_t flags;
+
+    bool Any() const { return (stats | flags) != 0; }
+};
+
+inline GameStatsDiff DiffGameStats(const GameStats& a, const GameStats& b)
+{
+    GameStatsDiff diff;
+
+#ifdef TATOOSH_GAME_STATS_SSE2
+    uint32_t equal = 0;
+    for (size_t i = 0; i < GAME_STAT_SLOTS; i += 4) {
+        __m128i va = _mm_load_si128(reinterpret_cast<const __m128i*>(a.values + i));
+        __m128i vb = _mm_load_si128(reinterpret_cast<const __m128i*>(b.values + i));
+        __m128 eq = _mm_castsi128_ps(_mm_cmpeq_epi32(va, vb));
+        equal |= static_cast<uint32_t>(_mm_movemask_ps(eq)) << i;
+    }
+    diff.stats = ~equal;
+#else
+    diff.stats = 0;
+    for (size_t i = 0; i < GAME_STAT_SLOTS; ++i) {
+        diff.stats |= static_cast<uint32_t>(a.values[i] != b.values[i]) << i;
+    }
+#endif
+
+    // Padding slots never differ, but keep the mask to real stats regardless
+    if constexpr (GAME_STAT_COUNT < 32) {
+        diff.stats &= (1u << GAME_STAT_COUNT) - 1u;
+    }
+    diff.flags = a.flags ^ b.flags;
+    return diff;
+}
+
+// Game state for the UI: the stat block plus level info
 struct GameState {
-    // Core stats (from cl.stats[])
-    int health = 100;
-    int armor = 0;
-    int ammo = 0;
-    int active_weapon = 0;
-
-    // Ammo counts
-    int shells = 0;
-    int nails = 0;
-    int rockets = 0;
-    int cells = 0;
-
-    // Level statistics
-    int monsters = 0;
-    int total_monsters = 0;
-    int secrets = 0;
-    int total_secrets = 0;
-
-    // Weapons owned (from cl.items bitflags)
-    bool has_shotgun = false;
-    bool has_super_shotgun = false;
-    bool has_nailgun = false;
-    bool has_super_nailgun = false;
-    bool has_grenade_launcher = false;
-    bool has_rocket_launcher = false;
-    bool has_lightning_gun = false;
-
-    // Keys
-    bool has_key1 = false;  // Silver key
-    bool has_key2 = false;  // Gold key
-
-    // Powerups
-    bool has_invisibility = false;
-    bool has_invulnerability = false;
-    bool has_suit = false;
-    bool has_quad = false;
-
-    // Sigils (runes)
-    bool has_sigil1 = false;
-    bool has_sigil2 = false;
-    bool has_sigil3 = false;
-    bool has_sigil4 = false;
-
-    // Armor type (0=none, 1=green, 2=yellow, 3=red)
-    int armor_type = 0;
-
-    // Game state flags
-    bool intermission = false;
-    bool deathmatch = false;
-    bool coop = false;
+    GameStats stats;
 
     // Level info
     std::string level_name;
     std::string map_name;
-
-    // Time
-    int time_minutes = 0;
-    int time_seconds = 0;
-
-    // Face animation state (0-4 health tier, plus special states)
-    int face_index = 0;
-    bool face_pain = false;
 };
 
 } // namespace Tatoosh
@@ -8,16 +8,19 @@
 #ifndef TATOOSH_NOTIFICATION_STATE_H
 #define TATOOSH_NOTIFICATION_STATE_H
 
+#include <deque>
 #include <string>
 
 namespace Tatoosh {
 
-// Number of visible notify lines (matches Quake's NUM_CON_TIMES)
-constexpr int NUM_NOTIFY_LINES = 4;
+// Visible notify lines when ui_notifylines is unset (matches Quake's NUM_CON_TIMES)
+constexpr int DEFAULT_NOTIFY_LINES = 4;
+constexpr int MAX_NOTIFY_LINES = 32;
 
 struct NotifyLine {
     std::string text;
-    double time = 0.0; // realtime when the line appeared
+    double time = 0.0;   // realtime when the line, or its latest repeat, appeared
+    int count = 1;       // Identical prints collapsed into this line
 };
 
 struct NotificationState {
@@ -26,9 +29,20 @@ struct NotificationState {
     double centerprint_expire = 0.0; // realtime when it should disappear
     double centerprint_start = 0.0;  // realtime when it appeared
 
-    // Notify: rolling ring buffer of recent console lines
-    NotifyLine notify[NUM_NOTIFY_LINES];
-    int notify_head = 0; // next slot to write into
+    // Notify: visible console lines, oldest first. Each expires con_notifytime
+    // after its own time, read when checked, like Quake's con_times.
+    std::deque<NotifyLine> notify;
+
+    // Prints since the last update, applied together once per frame. Holds
+    // at most MAX_NOTIFY_LINES lines; older ones would scroll off anyway.
+    std::deque<NotifyLine> pending_notify;
+    std::string pending_centerprint;
+    double pending_centerprint_time = 0.0;
+    bool has_pending_centerprint = false;
+
+    // Rate limit: token bucket refilled at ui_notifyrate lines per second
+    double rate_tokens = 0.0;
+    double rate_time = 0.0;
 };
 
 } // namespace Tatoosh
@@ -0,0 +1,40 @@
+/*
+ * Tatoosh - Render Stats Type
+ *
+ * Per-frame command counters of the UI renderer.
+ * C-compatible struct used across the C/C++ boundary.
+ */
+
+#ifndef TATOOSH_RENDER_STATS_H
+#define TATOOSH_RENDER_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Vulkan commands the UI renderer emitted in the last frame, and the ones it
+ * skipped because the state they would set was already current. */
+typedef struct ui_render_stats_s {
+    unsigned int draw_calls;
+    unsigned int pipeline_binds;
+    unsigned int pipeline_binds_skipped;
+    unsigned int descriptor_binds;
+    unsigned int descriptor_binds_skipped;
+    unsigned int buffer_binds;           /* Vertex + index buffer pair */
+    unsigned int buffer_binds_skipped;
+    unsigned int scissor_sets;
+    unsigned int scissor_sets_skipped;
+    unsigned int push_constants;         /* Transform and translation pushed separately */
+    unsigned int push_constants_skipped;
+    unsigned int geometry_draws;         /* RenderGeometry calls from RmlUI */
+    unsigned int merged_draws;           /* Of those, folded into a neighbouring draw */
+    unsigned int batches_built;          /* Merged batches written, the rest reused from earlier frames */
+    unsigned int replayed;               /* 1 if the frame replayed the cached recording */
+    unsigned int dirty_rects;            /* Regions redrawn by a partial frame, 0 for a full one */
+} ui_render_stats_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TATOOSH_RENDER_STATS_H
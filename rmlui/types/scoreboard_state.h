@@ -0,0 +1,33 @@
+/*
+ * Tatoosh - Scoreboard State
+ *
+ * Pure data structures for the deathmatch player list.
+ * No framework dependencies — lives in types/ like game_state.h.
+ */
+
+#ifndef TATOOSH_SCOREBOARD_STATE_H
+#define TATOOSH_SCOREBOARD_STATE_H
+
+#include <string>
+
+namespace Tatoosh {
+
+// Most clients the scoreboard tracks; client numbers are 0 .. MAX_SCOREBOARD_PLAYERS-1
+constexpr int MAX_SCOREBOARD_PLAYERS = 64;
+
+// One row of the player list
+struct PlayerScore {
+    int client = 0;          // Stable key: cl.scores[] index
+    std::string name;
+    int frags = 0;
+    int ping = 0;
+    int top_color = 0;       // Quake color rows 0-13
+    int bottom_color = 0;
+    std::string top_rgb;     // CSS color of each row, for data-style bindings
+    std::string bottom_rgb;
+    bool self = false;       // The local player
+};
+
+} // namespace Tatoosh
+
+#endif // TATOOSH_SCOREBOARD_STATE_H
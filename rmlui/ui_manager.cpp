@@ -10,8 +10,15 @@
 #include "internal/system_interface.h"
 #include "internal/game_data_model.h"
 #include "internal/cvar_binding.h"
+#include "internal/cvar_handle.h"
 #include "internal/menu_event_handler.h"
 #include "internal/notification_model.h"
+#include "internal/scoreboard_model.h"
+#include "internal/hud_events.h"
+#include "internal/model_subscriptions.h"
+#include "internal/game_state_history.h"
+#include "internal/console_model.h"
+#include "internal/completion_index.h"
 
 #include <RmlUi/Core.h>
 #include <RmlUi/Debugger.h>
@@ -29,7 +36,6 @@
 extern "C" {
     extern double realtime;  // vkQuake's time reference
     void Con_Printf(const char* fmt, ...);
-    double Cvar_VariableValue(const char* var_name);
     void IN_Activate(void);
     void IN_Deactivate(int clear);
     void IN_EndIgnoringMouseEvents(void);
@@ -73,6 +79,10 @@ bool g_scoreboard_visible = false;
 bool g_intermission_visible = false;
 int g_last_intermission = 0;
 
+// Cvars read every frame
+Tatoosh::CvarHandle g_scr_style("scr_style");
+Tatoosh::CvarHandle g_scr_uiscale("scr_uiscale");
+
 // Deferred operations - processed during UI_Update to avoid race conditions with rendering
 bool g_pending_escape = false;  // ESC pressed, handle at next update
 bool g_pending_close_all = false;  // Request to close all menus at next update
@@ -85,10 +95,11 @@ std::string g_engine_base_path;   // com_basedir passed from engine
 const char* kHudDocSimple = "ui/rml/hud.rml";
 const char* kHudDocClassic = "ui/rml/hud/hud_classic.rml";
 const char* kHudDocModern = "ui/rml/hud/hud_modern.rml";
+const char* kConsoleDoc = "ui/rml/console.rml";
 
 const char* GetHudDocumentFromStyle()
 {
-    const double style = Cvar_VariableValue("scr_style");
+    const double style = g_scr_style.GetFloat();
     if (style < 1.0) {
         return kHudDocSimple;
     }
@@ -108,7 +119,7 @@ void UpdateDpRatio()
     float scale_y = static_cast<float>(g_height) / REFERENCE_HEIGHT;
     float base_ratio = (scale_x < scale_y) ? scale_x : scale_y;
 
-    float user_scale = static_cast<float>(Cvar_VariableValue("scr_uiscale"));
+    float user_scale = g_scr_uiscale.GetFloat();
     if (user_scale < DP_RATIO_MIN) user_scale = 1.0f;
 
     float dp_ratio = base_ratio * user_scale;
@@ -436,9 +447,9 @@ void UI_Shutdown(void)
     if (!g_initialized) return;
 
     // Shutdown data models first
-    Tatoosh::MenuEventHandler::Shutdown();
     Tatoosh::CvarBindingManager::Shutdown();
     Tatoosh::GameDataModel::Shutdown();
+    Tatoosh::ConsoleModel::Shutdown();
 
     // Unload all documents
     for (auto& pair : g_documents) {
@@ -457,6 +468,10 @@ void UI_Shutdown(void)
         g_context = nullptr;
     }
 
+    // After the context: its elements own the action listeners and detach
+    // them as they are destroyed
+    Tatoosh::MenuEventHandler::Shutdown();
+
     // Shutdown RmlUI
     Rml::Shutdown();
 
@@ -485,6 +500,18 @@ void UI_Shutdown(void)
     Con_Printf("UI_Shutdown: RmlUI shut down\n");
 }
 
+// Restart-requiring settings are only written by "apply_settings"; leaving a
+// menu any other way drops them, so the widgets never show values the engine
+// is not using
+static void UI_DiscardStagedSettings(void)
+{
+    if (Tatoosh::CvarBindingManager::IsInitialized() &&
+        Tatoosh::CvarBindingManager::HasStagedChanges()) {
+        Con_Printf("UI: Discarding unapplied settings\n");
+        Tatoosh::CvarBindingManager::RevertStaged();
+    }
+}
+
 // Internal function to process escape - called from UI_Update to avoid race conditions
 static void UI_ProcessPendingEscape(void)
 {
@@ -504,6 +531,7 @@ static void UI_ProcessPendingEscape(void)
     // Pop and hide current menu
     std::string current = g_menu_stack.back();
     g_menu_stack.pop_back();
+    UI_DiscardStagedSettings();
 
     auto it = g_documents.find(current);
     if (it != g_documents.end() && it->second) {
@@ -579,14 +607,30 @@ void UI_Update(double dt)
     // Note: Pending operations are now processed in UI_ProcessPending()
     // which is called from the main thread before rendering tasks start.
 
-    // Update game data model to sync with Quake state
-    Tatoosh::GameDataModel::Update();
+    // Models nobody is displaying skip their per-frame work entirely
+    Tatoosh::ModelSubscriptions::Refresh(g_visible ? g_context : nullptr);
+
+    if (Tatoosh::ModelSubscriptions::IsVisible("game")) {
+        // Update game data model to sync with Quake state
+        Tatoosh::GameDataModel::Update();
 
-    // Update notification expiry state
-    Tatoosh::NotificationModel::Update(realtime);
+        // Update notification expiry state
+        Tatoosh::NotificationModel::Update(realtime);
+
+        // Deliver the stat change events of the last sync
+        Tatoosh::HudEvents::Dispatch(g_context);
+    }
+
+    if (Tatoosh::ModelSubscriptions::IsVisible("console")) {
+        // Fit the rows to the viewport, step any search, refresh the rows
+        Tatoosh::ConsoleModel::Update();
+    }
 
     g_context->Update();
 
+    // Write this frame's setting edits back to their cvars, once each
+    Tatoosh::CvarBindingManager::FlushPending();
+
     // Clear any temporary suppression of UI change events after data bindings update.
     Tatoosh::CvarBindingManager::NotifyUIUpdateComplete();
 
@@ -726,6 +770,7 @@ int UI_LoadDocument(const char* path)
 
     // Resolve the path relative to UI base directory
     std::string resolved_path = ResolveUIPath(path);
+    Tatoosh::CvarBindingManager::AttachReferenced(resolved_path);
 
     Rml::ElementDocument* doc = g_context->LoadDocument(resolved_path);
     if (!doc) {
@@ -821,6 +866,7 @@ void UI_ReloadDocuments(void)
             std::string path = pair.first;
 
             pair.second->Close();
+            Tatoosh::CvarBindingManager::AttachReferenced(path);
             pair.second = g_context->LoadDocument(path);
 
             if (pair.second) {
@@ -888,8 +934,11 @@ void UI_InitializeVulkan(const void* config)
                 // Initialize data models now that context is ready
                 if (g_context) {
                     Tatoosh::GameDataModel::Initialize(g_context);
-                    Tatoosh::CvarBindingManager::Initialize(g_context);
+                    if (Tatoosh::CvarBindingManager::Initialize(g_context)) {
+                        Tatoosh::CvarBindingManager::LoadSchema(ResolveUIPath("ui/cvar_bindings.txt"));
+                    }
                     Tatoosh::MenuEventHandler::Initialize(g_context);
+                    Tatoosh::ConsoleModel::Initialize(g_context);
                 }
                 g_assets_loaded = true;
             }
@@ -907,6 +956,40 @@ void UI_BeginFrame(void* cmd, int width, int height)
     }
 }
 
+// Render into the pending draw list; the command buffer comes later, if at all
+ui_frame_update_t UI_PrepareFrame(int width, int height)
+{
+    if (!g_render_interface) return UI_FRAME_UNCHANGED;
+
+    g_render_interface->BeginFrame(VK_NULL_HANDLE, width, height);
+    if (g_initialized && g_context && g_visible) {
+        g_context->Render();
+    }
+    return g_render_interface->EvaluateFrame();
+}
+
+int UI_GetDirtyRects(ui_rect_t* rects, int max_rects)
+{
+    if (!g_render_interface) return 0;
+
+    const std::vector<VkRect2D>& dirty = g_render_interface->GetDirtyRects();
+    for (int i = 0; i < max_rects && i < static_cast<int>(dirty.size()); ++i) {
+        rects[i].x = dirty[i].offset.x;
+        rects[i].y = dirty[i].offset.y;
+        rects[i].width = static_cast<int>(dirty[i].extent.width);
+        rects[i].height = static_cast<int>(dirty[i].extent.height);
+    }
+    return static_cast<int>(dirty.size());
+}
+
+// Record the prepared frame into the UI pass; drawn at UI_EndFrame
+void UI_RecordFrame(void* cmd)
+{
+    if (g_render_interface) {
+        g_render_interface->SetCommandBuffer(static_cast<VkCommandBuffer>(cmd));
+    }
+}
+
 // Called after UI rendering
 void UI_EndFrame(void)
 {
@@ -915,6 +998,13 @@ void UI_EndFrame(void)
     }
 }
 
+// Semaphore the engine's frame submit waits on, if upload_semaphore is set
+VkSemaphore UI_GetUploadSemaphore(void)
+{
+    if (!g_render_interface) return VK_NULL_HANDLE;
+    return g_render_interface->TakeUploadSemaphore();
+}
+
 // Garbage collection - call after GPU fence wait
 void UI_CollectGarbage(void)
 {
@@ -923,6 +1013,48 @@ void UI_CollectGarbage(void)
     }
 }
 
+void UI_PrintMemoryStats(void)
+{
+    if (!g_render_interface || !g_render_interface->IsInitialized()) {
+        Con_Printf("UI memory heap not initialized\n");
+        return;
+    }
+
+    const Tatoosh::MemoryHeap& heap = g_render_interface->GetMemoryHeap();
+    for (const Tatoosh::MemoryPoolStats& pool : heap.GetPoolStats()) {
+        Con_Printf("type %2u %-6s %-6s: %u blocks, %u allocs, %llu/%llu KB used, largest free %llu KB\n",
+            pool.memory_type,
+            pool.kind == Tatoosh::MemoryKind::Image ? "image" : "buffer",
+            pool.host_visible ? "host" : "device",
+            pool.block_count, pool.allocation_count,
+            static_cast<unsigned long long>(pool.used_bytes / 1024),
+            static_cast<unsigned long long>(pool.reserved_bytes / 1024),
+            static_cast<unsigned long long>(pool.largest_free / 1024));
+    }
+
+    Tatoosh::MemoryHeapStats stats = heap.GetStats();
+    Con_Printf("total: %u blocks, %llu/%llu KB used (%llu KB requested), %u dedicated (%llu KB)\n",
+        stats.block_count,
+        static_cast<unsigned long long>(stats.used_bytes / 1024),
+        static_cast<unsigned long long>(stats.reserved_bytes / 1024),
+        static_cast<unsigned long long>(stats.requested_bytes / 1024),
+        stats.dedicated_count,
+        static_cast<unsigned long long>(stats.dedicated_bytes / 1024));
+    Con_Printf("fragmentation: internal %.1f%%, external %.1f%%\n",
+        stats.internal_fragmentation * 100.0f, stats.external_fragmentation * 100.0f);
+}
+
+void UI_GetRenderStats(ui_render_stats_t* stats)
+{
+    if (!stats) return;
+
+    if (g_render_interface) {
+        *stats = g_render_interface->GetFrameStats();
+    } else {
+        *stats = ui_render_stats_t{};
+    }
+}
+
 // Input mode control
 void UI_SetInputMode(ui_input_mode_t mode)
 {
@@ -1005,6 +1137,7 @@ void UI_CloseAllMenusImmediate(void)
         }
     }
     g_menu_stack.clear();
+    UI_DiscardStagedSettings();
 
     // Transition to inactive and restore game input
     UI_SetInputMode(UI_INPUT_INACTIVE);
@@ -1024,7 +1157,10 @@ void UI_PushMenu(const char* path)
     // showing the document.  LoadDocument() creates elements that read the data
     // model immediately, and Show() on an already-loaded document relies on the
     // dirty-data mechanism to refresh elements on the next Update().
-    if (Tatoosh::CvarBindingManager::IsInitialized()) {
+    // Once the engine reports cvar changes (UI_CvarChanged), the backing
+    // stores are already current and there is nothing to re-read.
+    if (Tatoosh::CvarBindingManager::IsInitialized() &&
+        !Tatoosh::CvarBindingManager::HasChangeNotifications()) {
         Tatoosh::CvarBindingManager::SyncToUI();
     }
 
@@ -1033,6 +1169,7 @@ void UI_PushMenu(const char* path)
     if (it == g_documents.end() || !it->second) {
         // Resolve the path relative to UI base directory
         std::string resolved_path = ResolveUIPath(path);
+        Tatoosh::CvarBindingManager::AttachReferenced(resolved_path);
 
         Rml::ElementDocument* doc = g_context->LoadDocument(resolved_path);
         if (!doc) {
@@ -1198,10 +1335,70 @@ void UI_SyncGameState(const int* stats, int items,
         g_last_intermission = intermission;
     }
 
+    // The HUD or intermission may have been shown just above
+    Tatoosh::ModelSubscriptions::Refresh(g_visible ? g_context : nullptr);
+
     GameDataModel_SyncFromQuake(stats, items, intermission, gametype,
                                 maxclients, level_name, map_name, game_time);
 }
 
+void UI_PrintGameState(void)
+{
+    GameDataModel_PrintState();
+}
+
+int UI_GetStatHistory(const char* stat_name, float* values, int max_values)
+{
+    if (!stat_name || !values || max_values <= 0) return 0;
+
+    for (size_t i = 0; i < Tatoosh::GAME_STAT_COUNT; ++i) {
+        if (std::strcmp(Tatoosh::GAME_STAT_NAMES[i], stat_name) == 0) {
+            return static_cast<int>(Tatoosh::g_game_state_history.SampleStat(
+                static_cast<Tatoosh::GameStat>(i), values, static_cast<size_t>(max_values)));
+        }
+    }
+    return 0;
+}
+
+double UI_GetStatHistorySpan(void)
+{
+    const Tatoosh::GameStateHistory& history = Tatoosh::g_game_state_history;
+    Tatoosh::GameStateSample first, last;
+    if (!history.Get(0, first) || !history.Get(history.Size() - 1, last)) return 0.0;
+    return last.time - first.time;
+}
+
+void UI_ClearStatHistory(void)
+{
+    Tatoosh::g_game_state_history.Clear();
+}
+
+// ── Cvar change notifications ──────────────────────────────────────
+
+void UI_CvarChanged(const char* cvar_name)
+{
+    Tatoosh::CvarBindingManager::OnCvarChanged(cvar_name);
+}
+
+// ── Deathmatch scoreboard ──────────────────────────────────────────
+
+void UI_UpdatePlayerScore(int client, const char* name, int frags, int ping,
+                          int top_color, int bottom_color, int is_self)
+{
+    Tatoosh::ScoreboardModel::UpdatePlayer(client, name, frags, ping,
+                                           top_color, bottom_color, is_self != 0);
+}
+
+void UI_RemovePlayerScore(int client)
+{
+    Tatoosh::ScoreboardModel::RemovePlayer(client);
+}
+
+void UI_ClearPlayerScores(void)
+{
+    Tatoosh::ScoreboardModel::Clear();
+}
+
 // ── Notification system ────────────────────────────────────────────
 
 void UI_NotifyCenterPrint(const char* text)
@@ -1216,6 +1413,66 @@ void UI_NotifyPrint(const char* text)
     Tatoosh::NotificationModel::NotifyPrint(text, realtime);
 }
 
+// ── Console ────────────────────────────────────────────────────────
+
+void UI_ConsolePrint(const char* text)
+{
+    // Recorded before UI_Init too, so the console shows the startup log
+    Tatoosh::ConsoleModel::Print(text);
+}
+
+int UI_IsConsoleOpen(void)
+{
+    return !g_menu_stack.empty() && g_menu_stack.back() == kConsoleDoc;
+}
+
+void UI_CompletionAdd(const char* name, ui_completion_kind_t kind)
+{
+    Tatoosh::g_completion_index.Insert(name, kind);
+
+    // Called from Cvar_RegisterVariable: handles that missed may find it now
+    if (kind == UI_COMPLETION_CVAR) {
+        Tatoosh::CvarHandle::InvalidateAll();
+    }
+}
+
+void UI_CompletionRemove(const char* name)
+{
+    Tatoosh::g_completion_index.Remove(name);
+}
+
+int UI_CompleteName(const char* partial, const char** names, int max_names)
+{
+    if (!names || max_names <= 0) return 0;
+
+    const Tatoosh::CompletionIndex::Entry* results[Tatoosh::CompletionIndex::MAX_RESULTS];
+    size_t count = Tatoosh::g_completion_index.Complete(partial, results,
+                                                        static_cast<size_t>(max_names));
+    for (size_t i = 0; i < count; ++i) {
+        names[i] = results[i]->name.c_str();
+    }
+    return static_cast<int>(count);
+}
+
+void UI_ToggleConsole(void)
+{
+    if (!g_initialized || !g_context) return;
+
+    if (UI_IsConsoleOpen()) {
+        UI_PopMenu();
+        return;
+    }
+
+    UI_PushMenu(kConsoleDoc);
+
+    auto it = g_documents.find(kConsoleDoc);
+    if (it != g_documents.end() && it->second) {
+        if (Rml::Element* input = it->second->GetElementById("console-input")) {
+            input->Focus();
+        }
+    }
+}
+
 // ── Key capture ────────────────────────────────────────────────────
 
 int UI_IsCapturingKey(void)
@@ -7,6 +7,9 @@
 #define TATOOSH_UI_MANAGER_H
 
 #include "types/input_mode.h"
+#include "types/frame_update.h"
+#include "types/render_stats.h"
+#include "types/completion_kind.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -84,10 +87,52 @@ void UI_SyncGameState(const int* stats, int items,
                       const char* level_name, const char* map_name,
                       double game_time);
 
+/* Print every synced stat and flag to the console */
+void UI_PrintGameState(void);
+
+/* Stat history - every sync is recorded in a fixed-size delta-encoded ring
+ * (about 256 KB, oldest dropped first), cleared when game time goes back.
+ * UI_GetStatHistory fills up to max_values samples of one stat ("health",
+ * "armor", ...), evenly spaced from oldest to newest, and returns the count.
+ * UI_GetStatHistorySpan returns the seconds the history covers. */
+int UI_GetStatHistory(const char* stat_name, float* values, int max_values);
+double UI_GetStatHistorySpan(void);
+void UI_ClearStatHistory(void);
+
+/* Deathmatch scoreboard - push each client's entry (e.g. from cl.scores[]
+ * while the scoreboard is up). Unchanged entries cost a compare; a frag
+ * change moves that one row to its new rank. Colors are Quake color rows. */
+void UI_UpdatePlayerScore(int client, const char* name, int frags, int ping,
+                          int top_color, int bottom_color, int is_self);
+void UI_RemovePlayerScore(int client);
+void UI_ClearPlayerScores(void);
+
+/* Cvar change hook - call from Cvar_SetQuick after a cvar's value changed.
+ * Bound menu values update in place and only that binding is dirtied; once
+ * this has been called, opening a menu no longer re-reads every bound cvar. */
+void UI_CvarChanged(const char* cvar_name);
+
 /* Notification system */
 void UI_NotifyCenterPrint(const char* text);
 void UI_NotifyPrint(const char* text);
 
+/* RmlUI console - feed every console print (fragments are fine, lines are
+ * split on '\n'); the scrollback records whether or not the console is open.
+ * UI_ToggleConsole opens ui/rml/console.rml as a menu or closes it. */
+void UI_ConsolePrint(const char* text);
+void UI_ToggleConsole(void);
+int UI_IsConsoleOpen(void);
+
+/* Completion index - call from Cmd_AddCommand, Cvar_RegisterVariable and
+ * alias creation (UI_CompletionRemove from unalias). Names registered before
+ * UI_Init are kept. Adding a cvar also makes cvar handles that found
+ * nothing look again. UI_CompleteName writes the best names starting with
+ * partial, ranked, and returns their count; the pointers are valid until the
+ * next add or remove. */
+void UI_CompletionAdd(const char* name, ui_completion_kind_t kind);
+void UI_CompletionRemove(const char* name);
+int UI_CompleteName(const char* partial, const char** names, int max_names);
+
 /* Key capture support (for rebinding UI) */
 int UI_IsCapturingKey(void);
 void UI_OnKeyCaptured(int key, const char* key_name);
@@ -114,16 +159,53 @@ typedef struct ui_vulkan_config_s {
     PFN_vkCmdPushConstants cmd_push_constants;
     PFN_vkCmdSetScissor cmd_set_scissor;
     PFN_vkCmdSetViewport cmd_set_viewport;
+    int descriptor_indexing;  /* Nonzero: descriptor indexing enabled, use bindless textures */
+    int secondary_command_buffers;  /* Nonzero: UI subpass takes secondary command buffers */
+    int partial_redraw;  /* Nonzero: UI pass can load the persistent UI image (attachment 0) */
+    int upload_semaphore;  /* Nonzero: frame submit waits on UI_GetUploadSemaphore() */
 } ui_vulkan_config_t;
 void UI_InitializeVulkan(const void* config);  /* Takes ui_vulkan_config_t* */
 
 /* Frame rendering hooks - called by vkQuake's render loop */
 void UI_BeginFrame(void* cmd, int width, int height);
+
+/* Records the UI draws and submits the frame's texture uploads to
+ * graphics_queue. The engine must submit the frame's command buffer to the
+ * same queue after this returns: the uploads end in a barrier into the
+ * fragment shader stage, which only orders work submitted later. */
 void UI_EndFrame(void);
 
+/* With upload_semaphore set: the semaphore the uploads of the last UI_EndFrame
+ * signal, or VK_NULL_HANDLE if there were none. Each non-null result must be
+ * waited on (at VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT) by the engine's next
+ * queue submit, and is returned only once. */
+VkSemaphore UI_GetUploadSemaphore(void);
+
+/* Persistent UI layer - alternative to UI_BeginFrame + UI_Render.
+ * UI_PrepareFrame renders the context without a command buffer and compares
+ * the result with the last recorded frame:
+ *   UI_FRAME_UNCHANGED - the previous UI image is current, skip the UI pass
+ *   UI_FRAME_FULL      - begin the UI pass clearing the image
+ *   UI_FRAME_PARTIAL   - begin the UI pass loading the image; only the dirty
+ *                        rects are cleared and redrawn (needs partial_redraw)
+ * Unless it returned UI_FRAME_UNCHANGED, call UI_RecordFrame inside the pass.
+ * Call UI_EndFrame either way. */
+ui_frame_update_t UI_PrepareFrame(int width, int height);
+void UI_RecordFrame(void* cmd);
+
+/* Regions a UI_FRAME_PARTIAL frame redraws, in pixels. Fills up to max_rects
+ * and returns the total count (0 for full and unchanged frames). */
+int UI_GetDirtyRects(ui_rect_t* rects, int max_rects);
+
 /* Garbage collection - call after GPU fence wait to safely destroy resources */
 void UI_CollectGarbage(void);
 
+/* Print UI device memory heap usage and fragmentation to the console */
+void UI_PrintMemoryStats(void);
+
+/* Command counters of the last rendered UI frame (emitted vs. skipped as redundant) */
+void UI_GetRenderStats(ui_render_stats_t* stats);
+
 #ifdef __cplusplus
 }
 #endif
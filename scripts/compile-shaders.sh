@@ -0,0 +1,43 @@
+#!/bin/bash
+# Compile the RmlUI renderer's GLSL shaders and embed them as SPIR-V
+# Usage: ./scripts/compile-shaders.sh
+#
+# Compiles rmlui/shaders/*.{vert,frag} → rmlui/internal/rmlui_shaders_embedded.h
+# Each shader becomes rmlui_<name>_<stage>_spv[] plus its _len, e.g.
+# rmlui_bindless.frag → rmlui_bindless_frag_spv.
+#
+# Requires glslangValidator (see setup.sh) and xxd.
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+SHADER_DIR="$PROJECT_ROOT/rmlui/shaders"
+OUTPUT="$PROJECT_ROOT/rmlui/internal/rmlui_shaders_embedded.h"
+
+# Order of the arrays in the header
+SHADERS="rmlui.vert rmlui.frag rmlui_notex.frag rmlui_bindless.frag"
+
+for tool in glslangValidator xxd; do
+    if ! command -v "$tool" &>/dev/null; then
+        echo "Error: $tool not found"
+        exit 1
+    fi
+done
+
+BUILD_DIR="$(mktemp -d)"
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+{
+    echo "// Auto-generated SPIR-V shader data for RmlUI"
+    echo "// Built from rmlui/shaders/ by scripts/compile-shaders.sh; do not edit"
+} > "$BUILD_DIR/header.h"
+for shader in $SHADERS; do
+    # rmlui_bindless.frag → rmlui_bindless_frag.spv, which xxd names rmlui_bindless_frag_spv
+    spv="$(echo "$shader" | tr . _).spv"
+    glslangValidator -V --target-env vulkan1.0 -o "$BUILD_DIR/$spv" "$SHADER_DIR/$shader"
+    (cd "$BUILD_DIR" && xxd -i "$spv") >> "$BUILD_DIR/header.h"
+done
+
+mv "$BUILD_DIR/header.h" "$OUTPUT"
+echo "Wrote $OUTPUT"